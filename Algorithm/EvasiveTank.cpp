@@ -1,8 +1,6 @@
 // Algorithm/EvasiveTank.cpp
 #include "EvasiveTank.h"
 #include "ActionRequest.h"
-#include <queue>
-#include <limits>
 
 // using namespace common;
 
@@ -11,13 +9,56 @@ EvasiveTank::EvasiveTank(int playerIndex, int /*tankIndex*/)
   : lastInfo_{1,1},
     direction_(playerIndex == 1 ? 6 : 2),
     shellsLeft_(-1),
-    needView_(true)
+    needView_(true),
+    enemyChar_(playerIndex == 1 ? '1' : '2'),
+    enemyX_(-1), enemyY_(-1),
+    turn_(0)
 {}
 
 // ——— updateBattleInfo ————————————————————————————————————————————————
 void EvasiveTank::updateBattleInfo(BattleInfo &baseInfo) {
     // We know baseInfo is actually MyBattleInfo
-    lastInfo_ = static_cast<MyBattleInfo&>(baseInfo);
+    auto &info = static_cast<MyBattleInfo&>(baseInfo);
+    if (info.isDelta) {
+        // patch our own grid with the cells that changed since last time
+        bool enemySeen = false;
+        for (auto const& ch : info.changes) {
+            if (ch.y < lastInfo_.rows && ch.x < lastInfo_.cols)
+                lastInfo_.grid[ch.y][ch.x] = ch.c;
+            if (ch.c == enemyChar_ && !(enemyX_ >= 0 && onSpawnMarker(ch.x, ch.y))) {
+                enemyX_ = int(ch.x);
+                enemyY_ = int(ch.y);
+                enemySeen = true;
+            }
+        }
+        if (!enemySeen && enemyX_ >= 0 &&
+            lastInfo_.grid[enemyY_][enemyX_] != enemyChar_) {
+            enemyX_ = enemyY_ = -1;   // gone from where we last saw it
+        }
+        lastInfo_.selfX = info.selfX;
+        lastInfo_.selfY = info.selfY;
+        lastInfo_.shellsRemaining = info.shellsRemaining;
+        lastInfo_.staticMap = info.staticMap;
+    } else {
+        // a window that moved: carry what we remember over to its coordinates
+        const long dx = long(lastInfo_.originX) - long(info.originX);
+        const long dy = long(lastInfo_.originY) - long(info.originY);
+        lastInfo_.adopt(info);   // swap grids with the Player's buffer, no copy
+        if (dx != 0 || dy != 0) {
+            for (auto& s : ownShells_) {
+                s.x += int(dx);
+                s.y += int(dy);
+            }
+            tracker_.shift(dx, dy);
+        }
+        enemyX_ = enemyY_ = -1;
+        for (std::size_t y = 0; y < lastInfo_.rows; ++y)
+            for (std::size_t x = 0; x < lastInfo_.cols; ++x)
+                if (lastInfo_.grid[y][x] == enemyChar_ && (enemyX_ < 0 || !onSpawnMarker(x, y))) {
+                    enemyX_ = int(x);
+                    enemyY_ = int(y);
+                }
+    }
     if (shellsLeft_ < 0) {
         shellsLeft_ = int(lastInfo_.shellsRemaining);
     }
@@ -26,51 +67,49 @@ void EvasiveTank::updateBattleInfo(BattleInfo &baseInfo) {
 
 // ——— getAction —————————————————————————————————————————————————————————
 ActionRequest EvasiveTank::getAction() {
-    return ActionRequest::Shoot;
+    ++turn_;
     // 1) first thing first: ask for view once
     if (needView_) {
         needView_ = false;
         return ActionRequest::GetBattleInfo;
     }
+    const std::size_t rows = lastInfo_.rows, cols = lastInfo_.cols;
+    const std::size_t sx = lastInfo_.selfX, sy = lastInfo_.selfY;
+    if (sx >= cols || sy >= rows) return ActionRequest::DoNothing;
 
-    // 2) scan out to 2 cells in each of the 8 dirs for any ‘*’
-    int bestDir = direction_;
-    int bestScore = -1;
-
-    for (int d = 0; d < 8; ++d) {
-        // compute distance to nearest shell in direction d
-        int dx = DX[d], dy = DY[d];
-        int dist = std::numeric_limits<int>::max();
-        for (int step = 1; step <= 2; ++step) {
-            int xx = int(lastInfo_.selfX) + dx*step;
-            int yy = int(lastInfo_.selfY) + dy*step;
-            if (xx<0||yy<0|| xx>=int(lastInfo_.cols) || yy>=int(lastInfo_.rows)) break;
-            if (lastInfo_.grid[yy][xx] == '*') {
-                dist = step;
-                break;
-            }
-        }
-        // want to maximize dist
-        if (dist > bestScore) {
-            bestScore = dist;
-            bestDir = d;
-        }
+    // We only turn in 90° steps, so plan 4-connected routes.
+    const std::uint64_t* pass = passableBits();
+    const std::size_t wpr = (cols + 63) / 64;
+    projectShells();
+
+    // 2) a shell will reach us soon: get off its line
+    std::uint8_t eta = danger_.turnsUntilHit(sx, sy);
+    if (eta >= 1 && eta <= kThreatRange) {
+        ActionRequest a = escape(pass);
+        if (a != ActionRequest::DoNothing) return a;
     }
 
-    // 3) if new bestDir differs, rotate toward it
-    if (bestDir != direction_) {
-        int diff = (bestDir - direction_ + 8) % 8;
-        direction_ = bestDir;
-        if (diff == 1 || diff == 2 || diff == 3) {
-            return ActionRequest::RotateRight90;
-        } else {
-            return ActionRequest::RotateLeft90;
+    // 3) enemy in sight: fire if lined up, otherwise close in along A*
+    if (enemyX_ >= 0) {
+        if (shellsLeft_ != 0) {
+            int x = int(sx) + DX[direction_], y = int(sy) + DY[direction_];
+            while (x >= 0 && y >= 0 && x < int(cols) && y < int(rows) &&
+                   lastInfo_.grid[y][x] != '#') {
+                if (x == enemyX_ && y == enemyY_) return shoot();
+                x += DX[direction_];
+                y += DY[direction_];
+            }
+        }
+        if (astar_.run(pass, cols, rows, wpr, sx, sy,
+                       std::size_t(enemyX_), std::size_t(enemyY_), false) >= 1) {
+            int dir = astar_.firstStep();
+            if (dir >= 0) return stepToward(dir);
         }
     }
 
-    // 4) otherwise move forward
-    int nx = int(lastInfo_.selfX) + DX[direction_];
-    int ny = int(lastInfo_.selfY) + DY[direction_];
+    // 4) nothing better to do: move forward, turning right at obstacles
+    int nx = int(sx) + DX[direction_];
+    int ny = int(sy) + DY[direction_];
     if (isFree(nx, ny)) {
         return ActionRequest::MoveForward;
     } else {
@@ -80,6 +119,136 @@ ActionRequest EvasiveTank::getAction() {
     }
 }
 
+// ——— stepToward ————————————————————————————————————————————————————————
+// Move if already facing `dir`, else rotate toward it (shorter way round).
+ActionRequest EvasiveTank::stepToward(int dir) {
+    if (dir == direction_) {
+        return ActionRequest::MoveForward;
+    }
+    int diff = (dir - direction_ + 8) % 8;
+    if (diff <= 4) {
+        direction_ = (direction_ + 2) % 8;
+        return ActionRequest::RotateRight90;
+    }
+    direction_ = (direction_ + 6) % 8;
+    return ActionRequest::RotateLeft90;
+}
+
+// ——— shoot —————————————————————————————————————————————————————————————
+ActionRequest EvasiveTank::shoot() {
+    ownShells_.push_back({int(lastInfo_.selfX), int(lastInfo_.selfY), direction_, turn_});
+    if (shellsLeft_ > 0) --shellsLeft_;
+    return ActionRequest::Shoot;
+}
+
+// ——— passableBits ———————————————————————————————————————————————————————
+// The simulator's precomputed bitset when we have it, else one built from the grid.
+// Either way spawn cells are blocked: the game manager never lets a tank back on one.
+const std::uint64_t* EvasiveTank::passableBits() {
+    const auto* sm = lastInfo_.staticMap;
+    if (sm && sm->width == lastInfo_.cols && sm->height == lastInfo_.rows) {
+        return sm->passable.data();
+    }
+    passable_.reset(lastInfo_.cols, lastInfo_.rows);
+    for (std::size_t y = 0; y < lastInfo_.rows; ++y) {
+        for (std::size_t x = 0; x < lastInfo_.cols; ++x) {
+            char c = lastInfo_.grid[y][x];
+            if (c == '.' || c == '*') passable_.set(x, y);
+        }
+    }
+    return passable_.bits.data();
+}
+
+// ——— projectShells ——————————————————————————————————————————————————————
+// Rebuilds the danger map from this turn's enemy shells.
+void EvasiveTank::projectShells() {
+    const int rows = int(lastInfo_.rows), cols = int(lastInfo_.cols);
+    if (danger_.width() != lastInfo_.cols || danger_.height() != lastInfo_.rows) {
+        // no setWall(): this game manager lets shells fly over walls
+        danger_.reset(lastInfo_.cols, lastInfo_.rows);
+    }
+
+    // drop our shells once they have left the board
+    for (std::size_t k = 0; k < ownShells_.size(); ) {
+        auto const& s = ownShells_[k];
+        int steps = int(turn_ - s.firedAt);
+        int x = s.x + DX[s.dir] * steps, y = s.y + DY[s.dir] * steps;
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            ownShells_[k] = ownShells_.back();
+            ownShells_.pop_back();
+        } else {
+            ++k;
+        }
+    }
+
+    // the tracker sees ours too (to tell directions apart), the map doesn't
+    shells_.clear();
+    tracker_.observe(lastInfo_.grid, lastInfo_.cols, lastInfo_.rows, shells_);
+    std::size_t n = 0;
+    for (auto const& s : shells_)
+        if (!isOwnShell(int(s.x), int(s.y))) shells_[n++] = s;
+    shells_.resize(n);
+    danger_.build(shells_.data(), shells_.size(), kThreatRange);
+}
+
+// ——— escape ————————————————————————————————————————————————————————————
+// Next step towards the nearest cell no shell reaches within kThreatRange,
+// never entering a cell a shell lands on next turn; DoNothing if boxed in.
+ActionRequest EvasiveTank::escape(const std::uint64_t* pass) {
+    const std::size_t rows = lastInfo_.rows, cols = lastInfo_.cols;
+    const std::size_t sx = lastInfo_.selfX, sy = lastInfo_.selfY;
+    const std::size_t wpr = (cols + 63) / 64;
+
+    // hit next turn where we stand: no time to turn, go straight if we can
+    if (danger_.turnsUntilHit(sx, sy) == 1) {
+        int nx = int(sx) + DX[direction_], ny = int(sy) + DY[direction_];
+        if (nx >= 0 && ny >= 0 && nx < int(cols) && ny < int(rows) &&
+            ((pass[std::size_t(ny) * wpr + std::size_t(nx >> 6)] >> (nx & 63)) & 1u) &&
+            danger_.turnsUntilHit(std::size_t(nx), std::size_t(ny)) != 1) {
+            return ActionRequest::MoveForward;
+        }
+    }
+
+    open_.reset(cols, rows);
+    safe_.reset(cols, rows);
+    for (std::size_t y = 0; y < rows; ++y) {
+        for (std::size_t x = 0; x < cols; ++x) {
+            std::uint8_t eta = danger_.turnsUntilHit(x, y);
+            if (eta != 1) open_.set(x, y);
+            if (eta > kThreatRange) safe_.set(x, y);
+        }
+    }
+    for (std::size_t k = 0; k < open_.bits.size(); ++k) {
+        open_.bits[k] &= pass[k];
+        safe_.bits[k] &= pass[k];
+    }
+    std::size_t gx = 0, gy = 0;
+    if (bfs_.run(open_.bits.data(), cols, rows, wpr, sx, sy, false,
+                 safe_.bits.data(), &gx, &gy)) {
+        int dir = bfs_.firstStep(gx, gy);
+        if (dir >= 0) return stepToward(dir);
+    }
+    return ActionRequest::DoNothing;
+}
+
+// ——— isOwnShell —————————————————————————————————————————————————————————
+bool EvasiveTank::isOwnShell(int x, int y) const {
+    for (auto const& s : ownShells_) {
+        int steps = int(turn_ - s.firedAt);
+        if (s.x + DX[s.dir] * steps == x && s.y + DY[s.dir] * steps == y) return true;
+    }
+    return false;
+}
+
+// ——— onSpawnMarker ——————————————————————————————————————————————————————
+// Spawn markers stay in the view after their tanks leave, so an enemy shown
+// on one is only believed when we see it nowhere else.
+bool EvasiveTank::onSpawnMarker(std::size_t x, std::size_t y) const {
+    const auto* sm = lastInfo_.staticMap;
+    return sm && sm->width == lastInfo_.cols && sm->height == lastInfo_.rows &&
+           !sm->isPassable(x, y);
+}
+
 // ——— isFree —————————————————————————————————————————————————————————————
 bool EvasiveTank::isFree(int x, int y) const {
     if (x<0 || y<0 || x>=int(lastInfo_.cols) || y>=int(lastInfo_.rows))
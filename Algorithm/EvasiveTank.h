@@ -3,11 +3,17 @@
 #include "TankAlgorithm.h"
 #include "MyBattleInfo.h"
 #include "ActionRequest.h"
-#include <queue>
-#include <limits>
+#include "Pathfinding.h"
+#include "DangerMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 /// A “stay clear of shells” tank.
-/// See ArenaBattle/EvasiveTank for a full description.
+/// Projects every enemy shell forward (DangerMap) and, when one will reach it
+/// soon, walks (BFS) to the nearest cell none will; otherwise chases the enemy
+/// along an A* route and fires once lined up. On a map too large to mirror the
+/// Player sends a window around the tank, and all of this happens inside it.
 class EvasiveTank : public TankAlgorithm {
 public:
     EvasiveTank(int playerIndex, int /*tankIndex*/);
@@ -23,10 +29,39 @@ private:
     int          direction_;
     int          shellsLeft_;
     bool         needView_;
+    char         enemyChar_;
+    int          enemyX_, enemyY_;        // -1 until seen
+    std::size_t  turn_;
+
+    /// Shells we fired: they only travel away from us, so never flee them.
+    struct OwnShell { int x, y, dir; std::size_t firedAt; };
+    std::vector<OwnShell> ownShells_;
+
+    /// Per-turn search state, kept so planning allocates nothing after turn one.
+    UserCommon_315634022::BitGrid  passable_;  // built from the grid if no staticMap
+    UserCommon_315634022::BitGrid  open_;      // escape routes: passable & not hit next turn
+    UserCommon_315634022::BitGrid  safe_;      // escape goals: passable & no shell within range
+    UserCommon_315634022::QueueBfs bfs_;
+    UserCommon_315634022::AStar    astar_;
+
+    UserCommon_315634022::ShellTracker                    tracker_;
+    UserCommon_315634022::DangerMap                       danger_;
+    std::vector<UserCommon_315634022::ShellSighting>      shells_;
 
     static constexpr int DX[8] = { 0,+1,+1,+1, 0,-1,-1,-1 };
     static constexpr int DY[8] = {-1,-1, 0,+1,+1,+1, 0,-1 };
 
+    /// A shell this many turns (or fewer) from a cell makes it unsafe.
+    static constexpr int kThreatRange = 4;
+
     /// Helper: within bounds and not a wall (‘#’), mine (‘@’) or tank (‘1’/‘2’).
     bool isFree(int x, int y) const;
+
+    bool isOwnShell(int x, int y) const;
+    bool onSpawnMarker(std::size_t x, std::size_t y) const;
+    const std::uint64_t* passableBits();
+    void projectShells();
+    ActionRequest escape(const std::uint64_t* pass);
+    ActionRequest stepToward(int dir);
+    ActionRequest shoot();
 };
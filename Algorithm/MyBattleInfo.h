@@ -1,6 +1,8 @@
 // Algorithm/MyBattleInfo.h
 #pragma once
 #include "BattleInfo.h"
+#include "DeltaSatelliteView.h"
+#include "StaticMapAnalysis.h"
 #include <vector>
 #include <cstddef>
 
@@ -11,10 +13,48 @@ struct MyBattleInfo : public BattleInfo {
     std::size_t selfX = 0, selfY = 0;
     std::size_t shellsRemaining = 0;
 
+    /// Delta mode: `grid` is left empty and `changes` holds only the cells that
+    /// changed since this tank's previous snapshot; patch your own copy.
+    bool isDelta = false;
+    std::vector<UserCommon_315634022::CellChange> changes;
+
+    /// Precomputed analysis of the static map (passable bits, wall distances,
+    /// ray lengths), shared read-only by every game on it; null if unavailable.
+    const UserCommon_315634022::StaticMapAnalysis* staticMap = nullptr;
+
+    /// Window mode, for maps too large to mirror per tank: `grid` is the
+    /// rows×cols window whose top-left is map cell (originX, originY), and
+    /// selfX/selfY are relative to it. Never a delta; staticMap is null.
+    bool windowed = false;
+    std::size_t originX = 0, originY = 0;
+
     MyBattleInfo(std::size_t r, std::size_t c)
       : rows(r), cols(c),
         grid(r, std::vector<char>(c,' ')),
         selfX(0), selfY(0),
         shellsRemaining(0)
     {}
+
+    /// Resize the grid to r×c, reusing the existing rows where they fit.
+    void reshape(std::size_t r, std::size_t c) {
+        rows = r; cols = c;
+        grid.resize(r);
+        for (auto &row : grid) row.resize(c, ' ');
+    }
+
+    /// Take over a full snapshot without copying it: the grids are swapped, so
+    /// `from` gets our previous grid back as the buffer for its next snapshot.
+    void adopt(MyBattleInfo &from) {
+        rows = from.rows;
+        cols = from.cols;
+        grid.swap(from.grid);
+        selfX = from.selfX;
+        selfY = from.selfY;
+        shellsRemaining = from.shellsRemaining;
+        staticMap = from.staticMap;
+        windowed = from.windowed;
+        originX = from.originX;
+        originY = from.originY;
+        isDelta = false;
+    }
 };
\ No newline at end of file
@@ -19,8 +19,13 @@
 #include "PlayerRegistration.h"
 #include "ActionRequest.h"
 #include "MyBattleInfo.h"
+#include "DeltaSatelliteView.h"
+
+#include <algorithm>
 
 using namespace Algorithm_315634022;
+using UserCommon_315634022::DeltaSatelliteView;
+using UserCommon_315634022::StaticMapAnalysisProvider;
 
 REGISTER_PLAYER(Player_315634022);
 
@@ -33,29 +38,139 @@ Player_315634022::Player_315634022(int playerIndex,
     rows_(rows),
     cols_(cols),
     shells_(num_shells),
-    first_(true)
+    // player indices are 0-based (see Simulator/main.cpp): tank '1' is player 0
+    selfChar_(char('1' + playerIndex))
 {}
 
 void Player_315634022::updateTankWithBattleInfo(TankAlgorithm &tank,
                                                SatelliteView &view) {
-    // build a fresh BattleInfo
-    MyBattleInfo info(rows_, cols_);
-    if (first_) {
-        info.shellsRemaining = shells_;
-        first_ = false;
+    auto* delta = dynamic_cast<const DeltaSatelliteView*>(&view);
+    if (delta && rows_ == 0 && cols_ == 0) {
+        rows_ = delta->height();
+        cols_ = delta->width();
+    }
+    if (rows_ * cols_ > kMaxMirroredCells) {
+        windowSnapshot(tank, view, delta);
+        return;
+    }
+    // asked for only past the window check: asking computes it on first use
+    auto* provider = dynamic_cast<const StaticMapAnalysisProvider*>(&view);
+    auto* staticMap = provider ? provider->staticAnalysis() : nullptr;
+
+    // delta mode: this tank already holds a grid, send only what changed
+    auto seen = seen_.find(&tank);
+    if (delta && seen != seen_.end()) {
+        MyBattleInfo &info = back_;
+        info.changes.clear();
+        if (delta->changesSince(seen->second.version, info.changes)) {
+            info.isDelta = true;
+            info.staticMap = staticMap;
+            info.shellsRemaining = 0;
+            if (!delta->selfPosition(seen->second.selfX, seen->second.selfY)) {
+                for (auto const& ch : info.changes) {
+                    if (isSelf(ch.c)) {
+                        seen->second.selfX = ch.x;
+                        seen->second.selfY = ch.y;
+                    }
+                }
+            }
+            seen->second.version = delta->version();
+            info.selfX = seen->second.selfX;
+            info.selfY = seen->second.selfY;
+            tank.updateBattleInfo(info);
+            return;
+        }
     }
-    // snapshot the grid and locate ourselves
+
+    // fill the back buffer (only reallocated if a tank handed back a grid
+    // of a different size, i.e. its very first one)
+    MyBattleInfo &info = back_;
+    if (info.grid.size() != rows_ || (rows_ && info.grid[0].size() != cols_)) {
+        info.reshape(rows_, cols_);
+    }
+    info.rows = rows_;
+    info.cols = cols_;
+    info.isDelta = false;
+    info.changes.clear();
+    info.staticMap = staticMap;
+    info.windowed = false;
+    info.originX = info.originY = 0;
+    info.selfX = info.selfY = 0;
+    // a tank's first snapshot tells it how many shells it starts with
+    info.shellsRemaining = seen == seen_.end() ? shells_ : 0;
+    // snapshot the grid and locate ourselves, unless the GM says where
+    const bool placed = delta && delta->selfPosition(info.selfX, info.selfY);
     for (std::size_t y = 0; y < rows_; ++y) {
         for (std::size_t x = 0; x < cols_; ++x) {
             char c = view.getObjectAt(x, y);
             info.grid[y][x] = c;
-            if ((playerIndex_ == 1 && c=='1') ||
-                (playerIndex_ == 2 && c=='2')) {
+            if (!placed && isSelf(c)) {
                 info.selfX = x;
                 info.selfY = y;
             }
         }
     }
+    seen_[&tank] = TankSnapshot{delta ? delta->version() : 0, info.selfX, info.selfY};
     // hand off to the tank algorithm
     tank.updateBattleInfo(info);
 }
+
+// A window of the map around the tank, as far as the map allows: on a map
+// too large to mirror, this is all a tank gets, every turn in full.
+void Player_315634022::windowSnapshot(TankAlgorithm &tank, SatelliteView &view,
+                                      const DeltaSatelliteView* delta) {
+    // where the tank is: the GM may say; else it is near where it was (it
+    // moves a cell a turn); else search the whole map
+    std::size_t sx = 0, sy = 0;
+    auto seen = seen_.find(&tank);
+    if (!(delta && delta->selfPosition(sx, sy)) &&
+        !(seen != seen_.end() &&
+          findSelf(view, seen->second.selfX, seen->second.selfY, 2, sx, sy))) {
+        findSelf(view, 0, 0, std::max(rows_, cols_), sx, sy);
+    }
+
+    const std::size_t h = std::min(rows_, 2 * kWindowRadius + 1);
+    const std::size_t w = std::min(cols_, 2 * kWindowRadius + 1);
+    const std::size_t ox = std::min(sx > kWindowRadius ? sx - kWindowRadius : 0, cols_ - w);
+    const std::size_t oy = std::min(sy > kWindowRadius ? sy - kWindowRadius : 0, rows_ - h);
+
+    MyBattleInfo &info = back_;
+    if (info.grid.size() != h || (h && info.grid[0].size() != w)) {
+        info.reshape(h, w);
+    }
+    info.rows = h;
+    info.cols = w;
+    info.isDelta = false;
+    info.changes.clear();
+    info.staticMap = nullptr;   // it covers the whole map
+    info.windowed = true;
+    info.originX = ox;
+    info.originY = oy;
+    info.selfX = sx - ox;
+    info.selfY = sy - oy;
+    info.shellsRemaining = seen == seen_.end() ? shells_ : 0;
+    for (std::size_t y = 0; y < h; ++y) {
+        for (std::size_t x = 0; x < w; ++x) {
+            info.grid[y][x] = view.getObjectAt(ox + x, oy + y);
+        }
+    }
+    seen_[&tank] = TankSnapshot{0, sx, sy};
+    tank.updateBattleInfo(info);
+}
+
+// Our tank within `radius` cells of (cx,cy), if it is there
+bool Player_315634022::findSelf(SatelliteView &view, std::size_t cx, std::size_t cy,
+                                std::size_t radius, std::size_t &x, std::size_t &y) const {
+    const std::size_t x0 = cx > radius ? cx - radius : 0, x1 = std::min(cols_, cx + radius + 1);
+    const std::size_t y0 = cy > radius ? cy - radius : 0, y1 = std::min(rows_, cy + radius + 1);
+    for (std::size_t j = y0; j < y1; ++j) {
+        for (std::size_t i = x0; i < x1; ++i) {
+            if (isSelf(view.getObjectAt(i, j))) {
+                x = i;
+                y = j;
+                return true;
+            }
+        }
+    }
+    return false;
+}
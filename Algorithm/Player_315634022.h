@@ -13,8 +13,10 @@
 // Algorithm/Player_315634022.h
 #pragma once
 #include "Player.h"
+#include "MyBattleInfo.h"
 #include <cstddef>
 #include <string>
+#include <unordered_map>
 
 namespace Algorithm_315634022 {
 
@@ -30,10 +32,36 @@ public:
                                   SatelliteView &view) override;
 
 private:
+    // Maps above this many cells are not mirrored per tank: each snapshot is
+    // a window reaching kWindowRadius cells around the tank, and the tank
+    // plans inside it alone.
+    static constexpr std::size_t kMaxMirroredCells = std::size_t(1) << 20;
+    static constexpr std::size_t kWindowRadius = 32;
+
+    void windowSnapshot(TankAlgorithm &tank, SatelliteView &view,
+                        const UserCommon_315634022::DeltaSatelliteView* delta);
+    bool findSelf(SatelliteView &view, std::size_t cx, std::size_t cy, std::size_t radius,
+                  std::size_t &x, std::size_t &y) const;
+    // our tank's own char, or the '%' a multi-tank GM marks the asking tank with
+    bool isSelf(char c) const { return c == selfChar_ || c == '%'; }
+
     int    playerIndex_;
     std::size_t rows_, cols_;
     std::size_t shells_;
-    bool   first_;
+    char   selfChar_;
+
+    // What each of our tanks last received, so later snapshots can be sent
+    // as deltas when the GM's view supports it (version is 0 without one).
+    struct TankSnapshot {
+        std::size_t version;
+        std::size_t selfX, selfY;
+    };
+    std::unordered_map<const TankAlgorithm*, TankSnapshot> seen_;
+
+    // Back buffer for the next snapshot. Tanks that understand MyBattleInfo
+    // take its grid by swap (MyBattleInfo::adopt) and leave their old grid
+    // here, so steady-state snapshots write the grid once and allocate nothing.
+    MyBattleInfo back_{0, 0};
 };
 
 } // namespace Algorithm_315634022
@@ -12,6 +12,6 @@ public:
     void updateBattleInfo(BattleInfo&) override {}
 };
 
-REGISTER_TANK_ALGORITHM(TankAlgorithmAlt_315634022)
+REGISTER_TANK_ALGORITHM(TankAlgorithmAlt_315634022);
 
 } // namespace AlgorithmAlt_315634022
@@ -0,0 +1,118 @@
+// Algorithm/bench_danger.cpp
+// Benchmarks DangerMap's two projection methods, the board sweeps and its own
+// ray walk, against a plain per-shell ray walk from a handful of shells to
+// tens of thousands, and checks that all of them agree. build() picks one
+// method per call; the "build" column shows what that choice costs.
+//
+//   make bench            (or: ./bench_danger [size] [shells] [horizon])
+#include "DangerMap.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace UserCommon_315634022;
+
+namespace {
+
+constexpr int DX[8] = {  0,  1,  1,  1,  0, -1, -1, -1 };
+constexpr int DY[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
+
+// Straightforward reference: walk every shell's line(s) cell by cell.
+void rayWalk(const std::vector<std::vector<char>>& grid, std::size_t w, std::size_t h,
+             const std::vector<ShellSighting>& shells, int horizon,
+             std::vector<std::uint8_t>& out)
+{
+    out.assign(w * h, DangerMap::kNever);
+    for (auto const& s : shells) {
+        out[s.y * w + s.x] = 0;
+        for (int d = 0; d < 8; ++d) {
+            if (!(s.dirMask & (1u << d))) continue;
+            long x = s.x, y = s.y;
+            for (int t = 1; t <= horizon; ++t) {
+                x += DX[d]; y += DY[d];
+                if (x < 0 || y < 0 || x >= long(w) || y >= long(h)) break;
+                if (grid[y][x] == '#') break;
+                std::uint8_t& c = out[std::size_t(y) * w + std::size_t(x)];
+                if (t < c) c = std::uint8_t(t);
+            }
+        }
+    }
+}
+
+template <class F>
+double bestOfMs(int reps, F&& f) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - t0;
+        if (dt.count() < best) best = dt.count();
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t size = argc > 1 ? std::size_t(std::atol(argv[1])) : 500;
+    const std::size_t nShells = argc > 2 ? std::size_t(std::atol(argv[2])) : 0;
+    const int horizon = argc > 3 ? std::atoi(argv[3]) : 16;
+    const std::size_t w = size, h = size;
+
+    std::mt19937 rng(42);
+    std::vector<std::vector<char>> grid(h, std::vector<char>(w, '.'));
+    for (auto& row : grid)
+        for (auto& c : row)
+            if (rng() % 100 < 15) c = '#';
+
+    DangerMap map;
+    map.reset(w, h);
+    for (std::size_t y = 0; y < h; ++y)
+        for (std::size_t x = 0; x < w; ++x)
+            if (grid[y][x] == '#') map.setWall(x, y);
+
+    std::printf("board %zux%zu, horizon %d%s\n", w, h, horizon,
+#if defined(__SSE2__)
+                ", SSE2"
+#else
+                ", scalar"
+#endif
+    );
+    const std::size_t counts[] = {10, 100, 1000, 5000, 20000};
+    for (std::size_t n : counts) {
+        if (nShells && n != nShells) n = nShells;
+        std::vector<ShellSighting> shells;
+        while (shells.size() < n) {
+            std::uint32_t x = std::uint32_t(rng() % w), y = std::uint32_t(rng() % h);
+            if (grid[y][x] == '#') continue;
+            // mostly tracked shells, some fresh ones of unknown direction
+            std::uint8_t mask = rng() % 10 == 0 ? 0xFF : std::uint8_t(1u << (rng() % 8));
+            shells.push_back({x, y, mask});
+        }
+
+        std::vector<std::uint8_t> ref;
+        double tRef = bestOfMs(3, [&] { rayWalk(grid, w, h, shells, horizon, ref); });
+
+        std::size_t bad = 0;
+        auto agree = [&] {
+            for (std::size_t y = 0; y < h; ++y)
+                for (std::size_t x = 0; x < w; ++x)
+                    bad += map.turnsUntilHit(x, y) != ref[y * w + x];
+        };
+        double tSweep = bestOfMs(10, [&] { map.sweepAll(shells.data(), shells.size(), horizon); });
+        agree();
+        double tRays = bestOfMs(10, [&] { map.walkRays(shells.data(), shells.size(), horizon); });
+        agree();
+        double tBuild = bestOfMs(10, [&] { map.build(shells.data(), shells.size(), horizon); });
+        agree();
+
+        std::printf("  %6zu shells: build %8.3f ms   sweeps %8.3f ms   rays %8.3f ms   reference %8.3f ms   mismatches %zu\n",
+                    n, tBuild, tSweep, tRays, tRef, bad);
+        if (bad) return 1;
+        if (nShells) break;
+    }
+    return 0;
+}
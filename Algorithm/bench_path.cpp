@@ -0,0 +1,158 @@
+// Algorithm/bench_path.cpp
+// Times one turn's worth of route planning (BitBfs, QueueBfs and AStar, as
+// EvasiveTank calls them) on a large board, call after call on the same
+// searchers, next to a plain queue BFS that allocates per call. Checks the
+// distances and first steps against that plain BFS, and that QueueBfs picks
+// the same goal and first step as BitBfs.
+//
+//   make bench            (or: ./bench_path [size] [searches])
+#include "Pathfinding.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+
+using namespace UserCommon_315634022;
+
+namespace {
+
+// Straightforward reference: 4-connected BFS with a queue. Goal cells need
+// not be passable, as for the searchers.
+void queueBfs(const BitGrid& pass, std::size_t sx, std::size_t sy,
+              std::vector<std::uint32_t>& dist)
+{
+    const std::size_t w = pass.width, h = pass.height;
+    dist.assign(w * h, BitBfs::kUnreached);
+    std::deque<std::size_t> q;
+    dist[sy * w + sx] = 0;
+    q.push_back(sy * w + sx);
+    while (!q.empty()) {
+        std::size_t c = q.front();
+        q.pop_front();
+        std::size_t x = c % w, y = c / w;
+        for (int k = 0; k < 8; k += 2) {
+            long nx = long(x) + kPathDX[k], ny = long(y) + kPathDY[k];
+            if (nx < 0 || ny < 0 || nx >= long(w) || ny >= long(h)) continue;
+            std::size_t n = std::size_t(ny) * w + std::size_t(nx);
+            if (dist[n] != BitBfs::kUnreached) continue;
+            dist[n] = dist[c] + 1;
+            if (pass.test(std::size_t(nx), std::size_t(ny))) q.push_back(n);
+        }
+    }
+}
+
+// a first step is right if it leads onto a passable cell one step closer
+bool goodStep(const BitGrid& pass, const std::vector<std::uint32_t>& toTarget,
+              std::size_t sx, std::size_t sy, int dir)
+{
+    if (dir < 0 || (dir & 1)) return false;
+    long nx = long(sx) + kPathDX[dir], ny = long(sy) + kPathDY[dir];
+    if (nx < 0 || ny < 0 || nx >= long(pass.width) || ny >= long(pass.height)) return false;
+    const std::size_t n = std::size_t(ny) * pass.width + std::size_t(nx);
+    return toTarget[n] + 1 == toTarget[sy * pass.width + sx] &&
+           (toTarget[n] == 0 || pass.test(std::size_t(nx), std::size_t(ny)));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t size = argc > 1 ? std::size_t(std::atol(argv[1])) : 500;
+    const std::size_t searches = argc > 2 ? std::size_t(std::atol(argv[2])) : 200;
+    const std::size_t w = size, h = size;
+
+    std::mt19937 rng(42);
+    BitGrid pass, goals;
+    pass.reset(w, h);
+    goals.reset(w, h);
+    for (std::size_t y = 0; y < h; ++y)
+        for (std::size_t x = 0; x < w; ++x) {
+            if (rng() % 100 >= 15) pass.set(x, y);
+            if (rng() % 5000 == 0) goals.set(x, y);   // a few far-off safe cells
+        }
+    auto openCell = [&] {
+        for (;;) {
+            std::size_t x = rng() % w, y = rng() % h;
+            if (pass.test(x, y)) return std::make_pair(x, y);
+        }
+    };
+
+    BitBfs bfs;
+    QueueBfs qbfs;
+    AStar astar;
+    std::vector<std::uint32_t> ref;
+    double plainMs = 0, fillMs = 0, qfillMs = 0, goalMs = 0, qgoalMs = 0, astarMs = 0, worstMs = 0;
+    std::size_t bad = 0;
+    auto timed = [&](auto&& f) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - t0;
+        if (dt.count() > worstMs) worstMs = dt.count();
+        return dt.count();
+    };
+
+    for (std::size_t i = 0; i < searches; ++i) {
+        auto [sx, sy] = openCell();
+        auto [tx, ty] = openCell();
+
+        // 1) distances to every cell
+        fillMs += timed([&] { bfs.run(pass.bits.data(), w, h, pass.wordsPerRow, sx, sy, false); });
+        qfillMs += timed([&] { qbfs.run(pass.bits.data(), w, h, pass.wordsPerRow, sx, sy, false); });
+        plainMs += timed([&] { queueBfs(pass, sx, sy, ref); });
+        for (std::size_t y = 0; y < h; ++y)
+            for (std::size_t x = 0; x < w; ++x)
+                if (pass.test(x, y)) {
+                    bad += bfs.distance(x, y) != ref[y * w + x];
+                    bad += qbfs.distance(x, y) != ref[y * w + x];
+                }
+
+        // 2) nearest goal cell and the first step there (EvasiveTank's escape)
+        std::size_t gx = 0, gy = 0;
+        int dir = -1;
+        bool found = false;
+        goalMs += timed([&] {
+            found = bfs.run(pass.bits.data(), w, h, pass.wordsPerRow, sx, sy, false,
+                            goals.bits.data(), &gx, &gy);
+            if (found) dir = bfs.firstStep(gx, gy);
+        });
+        if (found && (gx != sx || gy != sy)) {
+            queueBfs(pass, gx, gy, ref);
+            bad += !goodStep(pass, ref, sx, sy, dir);
+        }
+        std::size_t qx = 0, qy = 0;
+        int qdir = -1;
+        bool qfound = false;
+        qgoalMs += timed([&] {
+            qfound = qbfs.run(pass.bits.data(), w, h, pass.wordsPerRow, sx, sy, false,
+                              goals.bits.data(), &qx, &qy);
+            if (qfound) qdir = qbfs.firstStep(qx, qy);
+        });
+        bad += qfound != found;
+        if (found && qfound) bad += qx != gx || qy != gy || qdir != dir;
+
+        // 3) A* to one target and its first step (EvasiveTank's chase)
+        long len = -1;
+        astarMs += timed([&] {
+            len = astar.run(pass.bits.data(), w, h, pass.wordsPerRow, sx, sy, tx, ty, false);
+            if (len >= 1) dir = astar.firstStep();
+        });
+        queueBfs(pass, tx, ty, ref);
+        const std::uint32_t want = ref[sy * w + sx];
+        bad += (len < 0) != (want == BitBfs::kUnreached);
+        if (len >= 0) bad += std::uint32_t(len) != want;
+        if (len >= 1) bad += !goodStep(pass, ref, sx, sy, dir);
+    }
+
+    const double n = double(searches);
+    std::printf("board %zux%zu, 15%% walls, %zu searches per kind, 4-connected\n", w, h, searches);
+    std::printf("  plain queue BFS   %8.3f ms/search (full fill, allocating)\n", plainMs / n);
+    std::printf("  BitBfs full fill  %8.3f ms/search\n", fillMs / n);
+    std::printf("  QueueBfs full fill%8.3f ms/search\n", qfillMs / n);
+    std::printf("  BitBfs to goals   %8.3f ms/search (with firstStep)\n", goalMs / n);
+    std::printf("  QueueBfs to goals %8.3f ms/search (with firstStep)\n", qgoalMs / n);
+    std::printf("  AStar to target   %8.3f ms/search (with firstStep)\n", astarMs / n);
+    std::printf("  slowest search    %8.3f ms   mismatches %zu\n", worstMs, bad);
+    return bad ? 1 : 0;
+}
@@ -3,241 +3,854 @@
 #include "GameManager_315634022.h"
 #include <ActionRequest.h>
 #include <GameManagerRegistration.h>
+#include <DeltaSatelliteView.h>
+#include <StaticMapAnalysis.h>
+#include <TiledGrid.h>
+#include <WorkerTeam.h>
+#include <array>
+#include <deque>
 #include <iostream>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace GMNS = ::GameManager_315634022;
 using GM   = GMNS::GameManager_315634022;
-using Tank = GM::Tank;
-using Bullet = GM::Bullet;
 
 namespace GameManager_315634022 {
 
+using UserCommon_315634022::BatchGame;
+using UserCommon_315634022::CellChange;
+using UserCommon_315634022::DeltaSatelliteView;
+using UserCommon_315634022::StaticMapAnalysis;
+using UserCommon_315634022::StaticMapAnalysisProvider;
+using UserCommon_315634022::SparseTileGrid;
+using UserCommon_315634022::TileSource;
+using UserCommon_315634022::kTileMask;
+using UserCommon_315634022::kTileShift;
+using UserCommon_315634022::WorkerTeam;
+
+//------------------------------------------------------------------------------
+// Boards: the static map as the engine reads it, and the type of each game's
+// overlay (tanks and shells painted over it, 0 = none).
+//
+// GenericBoard reads the simulator's view and keeps sparse tiled overlays, so
+// any map size works. FixedBoard<N> is for maps that fit N×N (N a power of
+// two): a copy of the map in a std::array, padded with walls, and a dense
+// array overlay per game, so a lookup is one index with no virtual call.
+//------------------------------------------------------------------------------
+class GenericBoard {
+public:
+    using Overlay = SparseTileGrid<char>;
+
+    void reset(const SatelliteView& map, size_t w, size_t h) {
+        map_ = &map;
+        width_ = w;
+        height_ = h;
+    }
+
+    const SatelliteView& map() const { return *map_; }
+    size_t width()  const { return width_;  }
+    size_t height() const { return height_; }
+
+    // what a tank moving onto (x,y) finds; off the map is a wall
+    char terrain(int x, int y) const {
+        return (x>=0 && y>=0 && x<int(width_) && y<int(height_)) ? map_->getObjectAt(x,y) : '#';
+    }
+
+    // cell (x,y) as the views show it
+    char shown(const Overlay& overlay, size_t x, size_t y) const {
+        if (x < width_ && y < height_) {
+            if (char o = overlay.get(x, y))
+                return o;
+        }
+        // static map
+        return map_->getObjectAt(x,y);
+    }
+
+private:
+    const SatelliteView* map_ = nullptr;
+    size_t               width_ = 0, height_ = 0;
+};
+
+template <size_t N>
+class FixedBoard {
+    static_assert((N & (N - 1)) == 0, "FixedBoard side must be a power of two");
+public:
+    static constexpr size_t kCells = N * N;
+
+    class Overlay {
+    public:
+        void reset(size_t, size_t) { cells_.fill(0); }
+        char  get(size_t x, size_t y) const { return cells_[y * N + x]; }
+        char& at(size_t x, size_t y)        { return cells_[y * N + x]; }
+    private:
+        std::array<char, kCells> cells_;
+    };
+
+    void reset(const SatelliteView& map, size_t w, size_t h) {
+        map_ = &map;
+        width_ = w;
+        height_ = h;
+        cells_.fill('#');
+        for (size_t y = 0; y < h; ++y) {
+            for (size_t x = 0; x < w; ++x)
+                cells_[y * N + x] = map.getObjectAt(x, y);
+        }
+    }
+
+    const SatelliteView& map() const { return *map_; }
+    size_t width()  const { return width_;  }
+    size_t height() const { return height_; }
+
+    // both coordinates in [0, N) in one test; cells past the map are walls
+    char terrain(int x, int y) const {
+        return ((unsigned(x) | unsigned(y)) & ~unsigned(N - 1)) == 0
+             ? cells_[unsigned(y) * N + unsigned(x)] : '#';
+    }
+
+    char shown(const Overlay& overlay, size_t x, size_t y) const {
+        if (x < width_ && y < height_) {
+            if (char o = overlay.get(x, y))
+                return o;
+            return cells_[y * N + x];
+        }
+        return map_->getObjectAt(x,y);   // off the map: whatever the simulator says
+    }
+
+private:
+    const SatelliteView*     map_ = nullptr;
+    size_t                   width_ = 0, height_ = 0;
+    std::array<char, kCells> cells_;
+};
+
 //------------------------------------------------------------------------------
 // CompositeView overlays tanks & bullets onto the static map
 //------------------------------------------------------------------------------
-class CompositeView : public SatelliteView {
+template <class Board>
+class CompositeView : public DeltaSatelliteView, public StaticMapAnalysisProvider {
 public:
+    using Overlay = typename Board::Overlay;
+
     CompositeView(
-        const SatelliteView& base,
-        const std::vector<Tank>& tanks,
-        const std::vector<Bullet>& bullets,
-        size_t w, size_t h
+        const Board& board,
+        const Overlay& overlay,
+        const std::deque<std::vector<std::uint32_t>>* dirtyLog = nullptr,
+        size_t version = 0
     )
-      : base_(base), tanks_(tanks), bullets_(bullets),
-        width_(w), height_(h)
-    {}
+      : board_(board), overlay_(overlay), dirtyLog_(dirtyLog), version_(version)
+    {
+        // forward the simulator's analysis of the static map; it is only
+        // computed once someone asks for it
+        analysis_ = dynamic_cast<const StaticMapAnalysisProvider*>(&board.map());
+    }
 
-    char getObjectAt(size_t x, size_t y) const override {
-        // 1) tank?
-        for (int i = 0; i < 2; ++i) {
-            if (tanks_[i].alive &&
-                tanks_[i].x == int(x) &&
-                tanks_[i].y == int(y))
-            {
-                return char('1' + i);
+    // The same view as the tank at (x,y) sees it; with `markSelf` its own
+    // cell reads '%' (multi-tank games, where teammates look alike).
+    CompositeView forTank(int x, int y, bool markSelf) const {
+        CompositeView v(*this);
+        v.selfX_ = x;
+        v.selfY_ = y;
+        v.markSelf_ = markSelf;
+        return v;
+    }
+
+    const StaticMapAnalysis* staticAnalysis() const override {
+        return analysis_ ? analysis_->staticAnalysis() : nullptr;
+    }
+
+    size_t width()   const override { return board_.width();  }
+    size_t height()  const override { return board_.height(); }
+    size_t version() const override { return version_; }
+
+    bool changesSince(size_t since, std::vector<CellChange>& out) const override {
+        if (since > version_) return false;
+        size_t back = version_ - since;              // turns to replay
+        if (!dirtyLog_ || back > dirtyLog_->size()) return false;
+        const std::uint32_t w = std::uint32_t(board_.width());
+        for (size_t t = dirtyLog_->size() - back; t < dirtyLog_->size(); ++t) {
+            for (std::uint32_t cell : (*dirtyLog_)[t]) {
+                std::uint32_t x = cell % w, y = cell / w;
+                out.push_back({x, y, getObjectAt(x, y)});
             }
         }
-        // 2) bullet?
-        for (auto &b : bullets_) {
-            if (b.active && b.x == int(x) && b.y == int(y))
-                return '*';
-        }
-        // 3) static map
-        return base_.getObjectAt(x,y);
+        return true;
+    }
+
+    bool selfPosition(size_t& x, size_t& y) const override {
+        if (selfX_ < 0) return false;
+        x = size_t(selfX_);
+        y = size_t(selfY_);
+        return true;
+    }
+
+    char getObjectAt(size_t x, size_t y) const override {
+        // the asking tank itself, if marked?
+        if (markSelf_ && int(x) == selfX_ && int(y) == selfY_)
+            return '%';
+        // tank, bullet or static map
+        return board_.shown(overlay_, x, y);
     }
 
 private:
-    const SatelliteView&             base_;
-    const std::vector<Tank>&         tanks_;
-    const std::vector<Bullet>&       bullets_;
-    size_t                           width_, height_;
+    const Board&                     board_;
+    const Overlay&                   overlay_;
+    int                              selfX_ = -1, selfY_ = -1;
+    bool                             markSelf_ = false;
+    const std::deque<std::vector<std::uint32_t>>* dirtyLog_;
+    size_t                           version_;
+    const StaticMapAnalysisProvider* analysis_ = nullptr;
 };
 
 //------------------------------------------------------------------------------
-// ctor & debug
+// Tanks of every game in the batch, structure-of-arrays. The games share the
+// map and so the spawns: slot s is the s-th spawn (player 1's first, each side
+// in reading order; one a side unless multi-tank) and slot s of game g is at
+// s * games + g.
 //------------------------------------------------------------------------------
-GM::GameManager_315634022(bool verbose)
-  : verbose_(verbose), map_(nullptr), width_(0), height_(0)
-{}
+struct Tanks {
+    std::vector<int>          x, y, dir, shells;
+    std::vector<std::uint8_t> alive;
+};
+
+//------------------------------------------------------------------------------
+// Shells in flight in every game, structure-of-arrays, grouped by game
+// (shellsBegin_[g] up to shellsBegin_[g+1]), each game's in firing order.
+// live is -1 or 0 so that it can mask vector lanes.
+//------------------------------------------------------------------------------
+struct Shells {
+    std::vector<std::int32_t> x, y, dx, dy, owner, live, game;
+
+    size_t size() const { return x.size(); }
+    void resize(size_t n);
+    void push(int px, int py, int pdx, int pdy, int powner, size_t g);
+};
+
+void Shells::resize(size_t n) {
+    for (auto* v : {&x, &y, &dx, &dy, &owner, &live, &game}) v->resize(n);
+}
+
+void Shells::push(int px, int py, int pdx, int pdy, int powner, size_t g) {
+    x.push_back(px);   y.push_back(py);
+    dx.push_back(pdx); dy.push_back(pdy);
+    owner.push_back(powner);
+    live.push_back(-1);
+    game.push_back(std::int32_t(g));
+}
+
+//------------------------------------------------------------------------------
+// The game loop, on any board. runBatch() of the GM picks the instance.
+//------------------------------------------------------------------------------
+class EngineBase {
+public:
+    virtual ~EngineBase() {}
+    virtual std::vector<GameResult> runBatch(
+        size_t map_width, size_t map_height,
+        const SatelliteView& map,
+        std::string map_name,
+        size_t max_steps, size_t num_shells,
+        const std::vector<BatchGame>& games
+    ) = 0;
+};
+
+template <class Board>
+class Engine : public EngineBase {
+public:
+    explicit Engine(bool verbose) : verbose_(verbose) {}
+
+    std::vector<GameResult> runBatch(
+        size_t map_width, size_t map_height,
+        const SatelliteView& map,
+        std::string map_name,
+        size_t max_steps, size_t num_shells,
+        const std::vector<BatchGame>& games
+    ) override;
 
-void GM::debug(const std::string& msg) {
+private:
+    using View = CompositeView<Board>;
+
+    // What else one game of the batch carries.
+    struct Game {
+        Player*                                     players[2];
+        std::vector<std::unique_ptr<TankAlgorithm>> algs;      // by slot
+        std::vector<ActionRequest>                  actions;   // by slot, this turn
+
+        // Tanks and shells painted over the static map (0 = none), so a view
+        // lookup costs the same however many of them are on the board.
+        typename Board::Overlay    overlay;
+        std::vector<std::uint32_t> painted;   // cells set in overlay
+
+        // Cells (y*width+x) touched by each recent turn, oldest first; lets
+        // the per-turn view answer DeltaSatelliteView::changesSince() cheaply.
+        std::deque<std::vector<std::uint32_t>> dirtyLog;
+        std::vector<std::uint32_t>             dirty;     // this turn's
+        size_t                                 turn = 0;  // completed turns
+    };
+
+    bool verbose_;
+    const SatelliteView* map_ = nullptr;
+    size_t               width_ = 0, height_ = 0;
+    Board                board_;
+
+    bool                       multiTank_ = false;   // every spawn marker is a tank
+    std::vector<int>           slotPlayer_;   // owner of each tank slot
+    std::vector<Game>          games_;
+    Tanks                      tanks_;
+    Shells                     shells_;
+    Shells                     spare_;        // regroupShells() scratch
+    std::vector<std::uint32_t> shellsBegin_;  // games_.size() + 1 offsets
+    std::vector<std::uint32_t> cursor_;       // regroupShells() scratch
+    std::vector<std::int32_t>  hit_;          // resolveCollisions() scratch
+
+    // Decision phase: with SIM_DECISION_THREADS > 1 the Player and
+    // getAction() calls of a turn run on team_; actions are still applied
+    // in slot order.
+    std::unique_ptr<WorkerTeam> team_;
+
+    static constexpr size_t kDirtyHistory = 8;
+
+    void debug(const std::string& msg);
+    std::string tag(size_t g) const;
+    size_t tankAt(size_t slot, size_t g) const { return slot * games_.size() + g; }
+
+    void initGames(size_t num_shells, const std::vector<BatchGame>& games);
+    void paintOverlays(const std::vector<size_t>& which);
+    void markOccupied(const std::vector<size_t>& which);
+    void decideActions(const std::vector<size_t>& live);
+    void applyAction(size_t g, size_t slot);
+    void regroupShells();
+    void applyBulletMovement();
+    void resolveCollisions(const std::vector<size_t>& live);
+    bool oneSideDead(size_t g) const;
+    void advanceOneTurn(const std::vector<size_t>& live);
+    void retire(const std::vector<size_t>& which, size_t rounds, size_t max_steps,
+                std::vector<GameResult>& results);
+};
+
+//------------------------------------------------------------------------------
+// debug
+//------------------------------------------------------------------------------
+template <class Board>
+void Engine<Board>::debug(const std::string& msg) {
     if (verbose_) std::cerr << "[GM] " << msg << "\n";
 }
 
+// message prefix naming game g, if there is more than one
+template <class Board>
+std::string Engine<Board>::tag(size_t g) const {
+    return games_.size() > 1 ? "game " + std::to_string(g) + ": " : "";
+}
+
 //------------------------------------------------------------------------------
-// initialize tanks from the static map
+// initialize tanks from the static map, one set per game
 //------------------------------------------------------------------------------
-void GM::initTanks(
-    size_t /*max_steps*/, size_t num_shells,
-    TankAlgorithmFactory fac1,
-    TankAlgorithmFactory fac2
-) {
-    tanks_.clear();
-    tanks_.resize(2);
+template <class Board>
+void Engine<Board>::initGames(size_t num_shells, const std::vector<BatchGame>& games) {
+    // one tank a side, on the side's last spawn marker in reading order (at
+    // 0,0 without one); multi-tank, every marker is a tank: player 1's first,
+    // each side in reading order, which is also the order actions are applied
+    // in. A tiled map lets us skip tiles without a spawn, which on a large one
+    // is most.
+    std::vector<int> spawnX, spawnY;
+    slotPlayer_.clear();
+    if (!multiTank_) {
+        slotPlayer_ = {0, 1};
+        spawnX.assign(2, 0);
+        spawnY.assign(2, 0);
+    }
+    auto* tiled = dynamic_cast<const TileSource*>(map_);
+    for (int p = 0; p < 2; ++p) {
+        const char mark = char('1' + p);
+        for (size_t y = 0; y < height_; ++y) {
+            for (size_t x = 0; x < width_; ++x) {
+                char fill;
+                if (tiled && (x & kTileMask) == 0 &&
+                    tiled->uniformTile(x >> kTileShift, y >> kTileShift, fill) && fill != mark) {
+                    x += kTileMask;
+                    continue;
+                }
+                if (map_->getObjectAt(x,y) != mark) continue;
+                if (!multiTank_) {
+                    spawnX[size_t(p)] = int(x);
+                    spawnY[size_t(p)] = int(y);
+                    continue;
+                }
+                slotPlayer_.push_back(p);
+                spawnX.push_back(int(x));
+                spawnY.push_back(int(y));
+            }
+        }
+    }
 
-    for (size_t y = 0; y < height_; ++y) {
-        for (size_t x = 0; x < width_; ++x) {
-            char c = map_->getObjectAt(x,y);
-            if (c=='1') { tanks_[0].x = int(x); tanks_[0].y = int(y); }
-            if (c=='2') { tanks_[1].x = int(x); tanks_[1].y = int(y); }
+    const size_t K = games.size(), S = slotPlayer_.size();
+    tanks_.x.resize(S * K);
+    tanks_.y.resize(S * K);
+    tanks_.dir.resize(S * K);
+    tanks_.shells.assign(S * K, int(num_shells));
+    tanks_.alive.assign(S * K, 1);
+    for (size_t s = 0; s < S; ++s) {
+        for (size_t g = 0; g < K; ++g) {
+            tanks_.x[s * K + g]   = spawnX[s];
+            tanks_.y[s * K + g]   = spawnY[s];
+            tanks_.dir[s * K + g] = (slotPlayer_[s]==0 ? GM::E : GM::W);
         }
     }
 
-    for (int i = 0; i < 2; ++i) {
-        tanks_[i].dir    = (i==0 ? GM::E : GM::W);
-        tanks_[i].shells = int(num_shells);
-        tanks_[i].alive  = true;
-        tanks_[i].alg    = (i==0 ? fac1(i,0) : fac2(i,0));
+    games_ = std::vector<Game>(K);   // built in place: a Game is move-only
+    for (size_t g = 0; g < K; ++g) {
+        Game& G = games_[g];
+        G.players[0] = games[g].player1;
+        G.players[1] = games[g].player2;
+        int index[2] = { 0, 0 };
+        for (size_t s = 0; s < S; ++s) {
+            int p = slotPlayer_[s];
+            G.algs.push_back(p==0 ? games[g].factory1(p, index[p]) : games[g].factory2(p, index[p]));
+            ++index[p];
+        }
+        G.actions.assign(S, ActionRequest::DoNothing);
+        G.overlay.reset(width_, height_);
     }
 
-    bullets_.clear();
+    shells_.resize(0);
+    shellsBegin_.assign(K + 1, 0);
 }
 
 //------------------------------------------------------------------------------
-// move bullets one cell
+// redraw tanks & shells into each game's overlay; where several share a cell
+// the first tank shows, then any shell
 //------------------------------------------------------------------------------
-void GM::applyBulletMovement() {
-    for (auto &b : bullets_) {
-        if (!b.active) continue;
-        b.x += GM::DX[b.dir];
-        b.y += GM::DY[b.dir];
-        if (b.x<0 || b.y<0 || b.x>=int(width_) || b.y>=int(height_))
-            b.active = false;
+template <class Board>
+void Engine<Board>::paintOverlays(const std::vector<size_t>& which) {
+    const size_t S = slotPlayer_.size();
+    for (size_t g : which) {
+        Game& G = games_[g];
+        const std::uint32_t w = std::uint32_t(width_);
+        for (std::uint32_t cell : G.painted) G.overlay.at(cell % w, cell / w) = 0;
+        G.painted.clear();
+        auto paint = [&](int x, int y, char c) {
+            G.overlay.at(size_t(x), size_t(y)) = c;
+            G.painted.push_back(std::uint32_t(y) * w + std::uint32_t(x));
+        };
+        for (size_t i = shellsBegin_[g]; i < shellsBegin_[g + 1]; ++i)
+            if (shells_.live[i]) paint(shells_.x[i], shells_.y[i], '*');
+        for (size_t s = S; s-- > 0; ) {
+            size_t k = tankAt(s, g);
+            if (tanks_.alive[k]) paint(tanks_.x[k], tanks_.y[k], char('1' + slotPlayer_[s]));
+        }
+    }
+}
+
+// cells currently showing a tank or a shell, added to each game's dirty list
+template <class Board>
+void Engine<Board>::markOccupied(const std::vector<size_t>& which) {
+    const size_t S = slotPlayer_.size();
+    const std::uint32_t w = std::uint32_t(width_);
+    for (size_t g : which) {
+        auto& cells = games_[g].dirty;
+        for (size_t s = 0; s < S; ++s) {
+            size_t k = tankAt(s, g);
+            if (tanks_.alive[k]) cells.push_back(std::uint32_t(tanks_.y[k]) * w + std::uint32_t(tanks_.x[k]));
+        }
+        for (size_t i = shellsBegin_[g]; i < shellsBegin_[g + 1]; ++i)
+            if (shells_.live[i]) cells.push_back(std::uint32_t(shells_.y[i]) * w + std::uint32_t(shells_.x[i]));
     }
 }
 
 //------------------------------------------------------------------------------
-// resolve bullet‐tank hits
+// every live tank picks its action from the state at the start of the turn
 //------------------------------------------------------------------------------
-void GM::resolveCollisions() {
-    for (auto &b : bullets_) {
-        if (!b.active) continue;
-        for (int i = 0; i < 2; ++i) {
-            if (!tanks_[i].alive) continue;
-            if (b.owner!=i && b.x==tanks_[i].x && b.y==tanks_[i].y) {
-                debug("Tank " + std::to_string(i+1) + " was hit");
-                tanks_[i].alive = false;
-                b.active = false;
-            }
+template <class Board>
+void Engine<Board>::decideActions(const std::vector<size_t>& live) {
+    const size_t S = slotPlayer_.size();
+
+    // A Player serves all of its tanks and need not be thread-safe, so one
+    // job per (game, player) hands out its battle info, in slot order.
+    auto brief = [&](size_t job) {
+        size_t g = live[job / 2];
+        int    p = int(job % 2);
+        Game&  G = games_[g];
+        View view(board_, G.overlay, &G.dirtyLog, G.turn);
+        for (size_t s = 0; s < S; ++s) {
+            size_t k = tankAt(s, g);
+            if (slotPlayer_[s] != p || !tanks_.alive[k]) continue;
+            View own = view.forTank(tanks_.x[k], tanks_.y[k], multiTank_);
+            G.players[p]->updateTankWithBattleInfo(*G.algs[s], own);
+        }
+    };
+    // tank algorithms are separate objects: one job each
+    auto decide = [&](size_t job) {
+        size_t g = live[job / S], s = job % S;
+        Game&  G = games_[g];
+        G.actions[s] = tanks_.alive[tankAt(s, g)] ? G.algs[s]->getAction()
+                                                  : ActionRequest::DoNothing;
+    };
+
+    if (team_) {
+        team_->run(2 * live.size(), brief);
+        team_->run(S * live.size(), decide);
+    } else {
+        for (size_t j = 0; j < live.size(); ++j) {
+            brief(2 * j);
+            brief(2 * j + 1);
+            for (size_t s = 0; s < S; ++s) decide(j * S + s);
         }
     }
 }
 
 //------------------------------------------------------------------------------
-// have both tanks still alive?
+// carry out the action of tank `slot` in game g
 //------------------------------------------------------------------------------
-bool GM::oneSideDead() const {
-    return !(tanks_[0].alive && tanks_[1].alive);
+template <class Board>
+void Engine<Board>::applyAction(size_t g, size_t slot) {
+    const size_t k = tankAt(slot, g);
+    int &x = tanks_.x[k], &y = tanks_.y[k], &dir = tanks_.dir[k];
+    auto act = games_[g].actions[slot];
+    debug(tag(g) + "Tank" + std::to_string(slot+1) + " => " + std::to_string(int(act)));
+
+    switch (act) {
+      case ActionRequest::MoveForward: {
+        int nx = x + GM::DX[dir];
+        int ny = y + GM::DY[dir];
+        if (board_.terrain(nx, ny)=='.')
+        {
+            x = nx; y = ny;
+        }
+        break;
+      }
+      case ActionRequest::RotateLeft90:
+        dir = (dir + 6) % 8;
+        break;
+      case ActionRequest::RotateRight90:
+        dir = (dir + 2) % 8;
+        break;
+      case ActionRequest::Shoot:
+        if (tanks_.shells[k]>0) {
+          tanks_.shells[k]--;
+          shells_.push(x, y, GM::DX[dir], GM::DY[dir], slotPlayer_[slot], g);
+        }
+        break;
+      default:
+        break;
+    }
 }
 
 //------------------------------------------------------------------------------
-// one full turn: update->action->move->resolve
+// drop spent shells and group the rest (new ones included) by game; a
+// stable counting sort, so each game keeps its firing order
 //------------------------------------------------------------------------------
-void GM::advanceOneTurn() {
-    CompositeView view(*map_, tanks_, bullets_, width_, height_);
+template <class Board>
+void Engine<Board>::regroupShells() {
+    const size_t K = games_.size(), n = shells_.size();
+    shellsBegin_.assign(K + 1, 0);
+    for (size_t i = 0; i < n; ++i)
+        if (shells_.live[i]) ++shellsBegin_[size_t(shells_.game[i]) + 1];
+    std::partial_sum(shellsBegin_.begin(), shellsBegin_.end(), shellsBegin_.begin());
+
+    spare_.resize(shellsBegin_[K]);
+    cursor_.assign(shellsBegin_.begin(), shellsBegin_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        if (!shells_.live[i]) continue;
+        size_t j = cursor_[size_t(shells_.game[i])]++;
+        spare_.x[j]     = shells_.x[i];
+        spare_.y[j]     = shells_.y[i];
+        spare_.dx[j]    = shells_.dx[i];
+        spare_.dy[j]    = shells_.dy[i];
+        spare_.owner[j] = shells_.owner[i];
+        spare_.live[j]  = shells_.live[i];
+        spare_.game[j]  = shells_.game[i];
+    }
+    std::swap(shells_, spare_);
+}
 
-    // 1) player→build info→tank
-    for (int i = 0; i < 2; ++i) {
-        if (!tanks_[i].alive) continue;
-        players_[i]->updateTankWithBattleInfo(*tanks_[i].alg, view);
+//------------------------------------------------------------------------------
+// move bullets one cell: one pass over the whole batch, four at a time
+//------------------------------------------------------------------------------
+template <class Board>
+void Engine<Board>::applyBulletMovement() {
+    const size_t n = shells_.size();
+    std::int32_t *x = shells_.x.data(), *y = shells_.y.data(), *live = shells_.live.data();
+    const std::int32_t *dx = shells_.dx.data(), *dy = shells_.dy.data();
+    size_t i = 0;
+#if defined(__SSE2__)
+    auto load  = [](const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+    auto store = [](std::int32_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); };
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi32(int(width_)), h = _mm_set1_epi32(int(height_));
+    for (; i + 4 <= n; i += 4) {
+        __m128i vx = _mm_add_epi32(load(x + i), load(dx + i));
+        __m128i vy = _mm_add_epi32(load(y + i), load(dy + i));
+        store(x + i, vx);
+        store(y + i, vy);
+        __m128i in = _mm_and_si128(
+            _mm_andnot_si128(_mm_cmplt_epi32(vx, zero), _mm_cmplt_epi32(vx, w)),
+            _mm_andnot_si128(_mm_cmplt_epi32(vy, zero), _mm_cmplt_epi32(vy, h)));
+        store(live + i, _mm_and_si128(load(live + i), in));
+    }
+#endif
+    for (; i < n; ++i) {
+        x[i] += dx[i];
+        y[i] += dy[i];
+        if (x[i]<0 || y[i]<0 || x[i]>=int(width_) || y[i]>=int(height_))
+            live[i] = 0;
     }
+}
 
-    // 2) getAction + apply
-    for (int i = 0; i < 2; ++i) {
-        auto &T = tanks_[i];
-        if (!T.alive) continue;
-        auto act = T.alg->getAction();
-        debug("Tank" + std::to_string(i+1) + " => " + std::to_string(int(act)));
+//------------------------------------------------------------------------------
+// resolve bullet‐tank hits
+//------------------------------------------------------------------------------
+template <class Board>
+void Engine<Board>::resolveCollisions(const std::vector<size_t>& live) {
+    const size_t S = slotPlayer_.size();
+    const std::int32_t *x = shells_.x.data(), *y = shells_.y.data(), *owner = shells_.owner.data();
+    std::int32_t* alive = shells_.live.data();
+    hit_.assign(shells_.size(), 0);
+    std::int32_t* hit = hit_.data();
 
-        switch (act) {
-          case ActionRequest::MoveForward: {
-            int nx = T.x + GM::DX[T.dir];
-            int ny = T.y + GM::DY[T.dir];
-            if (nx>=0 && ny>=0 && nx<int(width_) && ny<int(height_) &&
-                map_->getObjectAt(nx,ny)=='.')
-            {
-                T.x = nx; T.y = ny;
+    // 1) flag every live shell standing on a live enemy tank of its game;
+    //    a game's shells are contiguous, so each tank is compared against
+    //    its game's run of shells four at a time
+    for (size_t g : live) {
+        const size_t b = shellsBegin_[g], e = shellsBegin_[g + 1];
+        if (b == e) continue;
+        for (size_t s = 0; s < S; ++s) {
+            const size_t k = tankAt(s, g);
+            if (!tanks_.alive[k]) continue;
+            const int tx = tanks_.x[k], ty = tanks_.y[k], p = slotPlayer_[s];
+            size_t i = b;
+#if defined(__SSE2__)
+            auto load = [](const std::int32_t* q) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(q)); };
+            const __m128i vtx = _mm_set1_epi32(tx), vty = _mm_set1_epi32(ty), vp = _mm_set1_epi32(p);
+            for (; i + 4 <= e; i += 4) {
+                __m128i on = _mm_and_si128(_mm_cmpeq_epi32(load(x + i), vtx),
+                                           _mm_cmpeq_epi32(load(y + i), vty));
+                on = _mm_andnot_si128(_mm_cmpeq_epi32(load(owner + i), vp), on);
+                on = _mm_and_si128(on, load(alive + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(hit + i), _mm_or_si128(load(hit + i), on));
             }
-            break;
-          }
-          case ActionRequest::RotateLeft90:
-            T.dir = GM::Dir8((T.dir + 6) % 8);
-            break;
-          case ActionRequest::RotateRight90:
-            T.dir = GM::Dir8((T.dir + 2) % 8);
-            break;
-          case ActionRequest::Shoot:
-            if (T.shells>0) {
-              T.shells--;
-              bullets_.push_back({T.x,T.y,T.dir,i,true});
+#endif
+            for (; i < e; ++i)
+                hit[i] |= alive[i] & -std::int32_t(x[i] == tx && y[i] == ty && owner[i] != p);
+        }
+    }
+
+    // 2) replay the flagged shells in firing order, exactly as a lone game
+    //    resolves them: a tank an earlier shell killed can't be hit again
+    for (size_t g : live) {
+        for (size_t i = shellsBegin_[g]; i < shellsBegin_[g + 1]; ++i) {
+            if (!hit[i]) continue;
+            for (size_t s = 0; s < S; ++s) {
+                const size_t k = tankAt(s, g);
+                if (!tanks_.alive[k]) continue;
+                if (owner[i]!=slotPlayer_[s] && x[i]==tanks_.x[k] && y[i]==tanks_.y[k]) {
+                    debug(tag(g) + "Tank " + std::to_string(s+1) + " was hit");
+                    tanks_.alive[k] = 0;
+                    alive[i] = 0;
+                }
             }
-            break;
-          default:
-            break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// has either side of game g lost all its tanks?
+//------------------------------------------------------------------------------
+template <class Board>
+bool Engine<Board>::oneSideDead(size_t g) const {
+    bool alive[2] = { false, false };
+    for (size_t s = 0; s < slotPlayer_.size(); ++s)
+        if (tanks_.alive[tankAt(s, g)]) alive[slotPlayer_[s]] = true;
+    return !(alive[0] && alive[1]);
+}
+
+//------------------------------------------------------------------------------
+// one full turn of every live game: update->action->move->resolve
+//------------------------------------------------------------------------------
+template <class Board>
+void Engine<Board>::advanceOneTurn(const std::vector<size_t>& live) {
+    // whatever is occupied now, or after this turn, may change
+    paintOverlays(live);
+    markOccupied(live);
+
+    // 1) player→build info→tank, then getAction
+    decideActions(live);
+
+    // 2) apply, always in slot order
+    const size_t S = slotPlayer_.size();
+    for (size_t g : live) {
+        for (size_t s = 0; s < S; ++s) {
+            if (tanks_.alive[tankAt(s, g)]) applyAction(g, s);
         }
     }
 
     // 3) bullet movement & collisions
+    regroupShells();
     applyBulletMovement();
-    resolveCollisions();
+    resolveCollisions(live);
+
+    markOccupied(live);
+    for (size_t g : live) {
+        Game& G = games_[g];
+        if (G.dirtyLog.size() == kDirtyHistory) G.dirtyLog.pop_front();
+        G.dirtyLog.push_back(std::move(G.dirty));
+        G.dirty = {};
+        ++G.turn;
+    }
 }
 
 //------------------------------------------------------------------------------
-// run: init everything, loop until end, then package GameResult
+// package the GameResult of each game in `which`; their shells stop flying
 //------------------------------------------------------------------------------
-GameResult GM::run(
+template <class Board>
+void Engine<Board>::retire(const std::vector<size_t>& which, size_t rounds, size_t max_steps,
+                std::vector<GameResult>& results) {
+    paintOverlays(which);
+    for (size_t g : which) {
+        GameResult& res = results[g];
+        res.rounds = rounds;
+        size_t left[2] = { 0, 0 };
+        for (size_t s = 0; s < slotPlayer_.size(); ++s)
+            if (tanks_.alive[tankAt(s, g)]) ++left[slotPlayer_[s]];
+        bool a1 = left[0] > 0;
+        bool a2 = left[1] > 0;
+
+        // winner
+        if      (a1 && !a2) res.winner = 1;
+        else if (!a1 && a2) res.winner = 2;
+        else                res.winner = 0;
+
+        // reason
+        if (!a1 && !a2)      res.reason = GameResult::ALL_TANKS_DEAD;
+        else if (rounds==max_steps) res.reason = GameResult::MAX_STEPS;
+        else                  res.reason = GameResult::ZERO_SHELLS;
+
+        // remaining tanks
+        res.remaining_tanks = { left[0], left[1] };
+
+        // final dynamic view
+        res.gameState = std::make_unique<View>(board_, games_[g].overlay);
+
+        for (size_t i = shellsBegin_[g]; i < shellsBegin_[g + 1]; ++i)
+            shells_.live[i] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// runBatch: init everything, loop until every game has ended, then package
+// the GameResults
+//------------------------------------------------------------------------------
+template <class Board>
+std::vector<GameResult> Engine<Board>::runBatch(
     size_t map_width, size_t map_height,
     const SatelliteView& map,
     std::string map_name,
     size_t max_steps, size_t num_shells,
-    Player& player1, std::string /*name1*/,
-    Player& player2, std::string /*name2*/,
-    TankAlgorithmFactory fac1,
-    TankAlgorithmFactory fac2
+    const std::vector<BatchGame>& games
 ) {
-    debug("Starting run on \"" + map_name + "\"");
+    debug("Starting run on \"" + map_name + "\"" +
+          (games.size() > 1 ? " (" + std::to_string(games.size()) + " games)" : ""));
     map_    = &map;
     width_  = map_width;
     height_ = map_height;
-    players_[0] = &player1;
-    players_[1] = &player2;
+    board_.reset(map, map_width, map_height);
+
+    // opt-in: SIM_MULTI_TANK set (to anything but 0) makes every '1'/'2' a
+    // tank and marks the asking tank '%' in its view
+    const char* multi = std::getenv("SIM_MULTI_TANK");
+    multiTank_ = multi && std::strcmp(multi, "0") != 0;
+    initGames(num_shells, games);
 
-    initTanks(max_steps, num_shells, fac1, fac2);
+    // opt-in: decide on a team of SIM_DECISION_THREADS threads (the
+    // simulator's decision_threads=); the outcome is the same either way
+    team_.reset();
+    if (const char* env = std::getenv("SIM_DECISION_THREADS")) {
+        long n = std::strtol(env, nullptr, 10);
+        if (n > 1) team_ = std::make_unique<WorkerTeam>(size_t(n));
+    }
+
+    std::vector<GameResult> results(games.size());
+    std::vector<size_t> live(games.size()), ended;
+    std::iota(live.begin(), live.end(), size_t(0));
 
     size_t stepCount = 0;
     for (; stepCount < max_steps; ++stepCount) {
-        if (oneSideDead()) break;
-        advanceOneTurn();
+        // a game with one side wiped out stops here, as it would on its own
+        ended.clear();
+        size_t n = 0;
+        for (size_t g : live) {
+            if (oneSideDead(g)) ended.push_back(g);
+            else                live[n++] = g;
+        }
+        live.resize(n);
+        if (!ended.empty()) retire(ended, stepCount, max_steps, results);
+        if (live.empty()) break;
+        advanceOneTurn(live);
     }
+    retire(live, stepCount, max_steps, results);
 
-    GameResult res;
-    res.rounds = stepCount;
-    bool a1 = tanks_[0].alive;
-    bool a2 = tanks_[1].alive;
+    team_.reset();
+    return results;
+}
 
-    // winner
-    if      (a1 && !a2) res.winner = 1;
-    else if (!a1 && a2) res.winner = 2;
-    else                res.winner = 0;
+//------------------------------------------------------------------------------
+// ctor
+//------------------------------------------------------------------------------
+GM::GameManager_315634022(bool verbose)
+  : verbose_(verbose)
+{}
 
-    // reason
-    if (!a1 && !a2)      res.reason = GameResult::ALL_TANKS_DEAD;
-    else if (stepCount==max_steps) res.reason = GameResult::MAX_STEPS;
-    else                  res.reason = GameResult::ZERO_SHELLS;
+GM::~GameManager_315634022() = default;
 
-    // remaining tanks
-    res.remaining_tanks = {
-        std::size_t(tanks_[0].alive),
-        std::size_t(tanks_[1].alive)
+//------------------------------------------------------------------------------
+// run: a batch of one game
+//------------------------------------------------------------------------------
+GameResult GM::run(
+    size_t map_width, size_t map_height,
+    const SatelliteView& map,
+    std::string map_name,
+    size_t max_steps, size_t num_shells,
+    Player& player1, std::string name1,
+    Player& player2, std::string name2,
+    TankAlgorithmFactory fac1,
+    TankAlgorithmFactory fac2
+) {
+    std::vector<BatchGame> one{
+        BatchGame{ &player1, std::move(name1), &player2, std::move(name2),
+                   std::move(fac1), std::move(fac2) }
     };
+    auto results = runBatch(map_width, map_height, map, std::move(map_name),
+                            max_steps, num_shells, one);
+    return std::move(results.front());
+}
 
-    // final dynamic view
-    res.gameState = std::make_unique<CompositeView>(
-        *map_, tanks_, bullets_, width_, height_
-    );
-
-    return res;
+//------------------------------------------------------------------------------
+// runBatch: the engine for the map's size class, fixed-size up to 32×32 and
+// generic beyond. SIM_GENERIC_ENGINE set (to anything but 0) forces the
+// generic one; the differential test uses it as the reference.
+//------------------------------------------------------------------------------
+std::vector<GameResult> GM::runBatch(
+    size_t map_width, size_t map_height,
+    const SatelliteView& map,
+    std::string map_name,
+    size_t max_steps, size_t num_shells,
+    const std::vector<BatchGame>& games
+) {
+    const char* env = std::getenv("SIM_GENERIC_ENGINE");
+    const bool generic = env && std::strcmp(env, "0") != 0;
+    const size_t side = std::max(map_width, map_height);
+    engine_.reset();
+    if      (generic)    engine_ = std::make_unique<Engine<GenericBoard>>(verbose_);
+    else if (side <= 8)  engine_ = std::make_unique<Engine<FixedBoard<8>>>(verbose_);
+    else if (side <= 16) engine_ = std::make_unique<Engine<FixedBoard<16>>>(verbose_);
+    else if (side <= 32) engine_ = std::make_unique<Engine<FixedBoard<32>>>(verbose_);
+    else                 engine_ = std::make_unique<Engine<GenericBoard>>(verbose_);
+    return engine_->runBatch(map_width, map_height, map, std::move(map_name),
+                             max_steps, num_shells, games);
 }
 
 //------------------------------------------------------------------------------
@@ -1,4 +1,4 @@
-// #pragma once
+#pragma once
 
 // #include <AbstractGameManager.h>
 
@@ -22,13 +22,13 @@
 // } // namespace GameManager_315634022
 // GameManager/GameManager_315634022.h
 
-#pragma once
-
 #include <AbstractGameManager.h>
+#include <BatchGameManager.h>
 #include <SatelliteView.h>
 #include <GameResult.h>
 #include <Player.h>
 #include <TankAlgorithm.h>
+#include <ActionRequest.h>
 
 #include <string>
 #include <vector>
@@ -36,9 +36,13 @@
 
 namespace GameManager_315634022 {
 
-class GameManager_315634022 : public AbstractGameManager {
+class EngineBase;
+
+class GameManager_315634022 : public AbstractGameManager,
+                              public UserCommon_315634022::BatchGameManager {
 public:
     explicit GameManager_315634022(bool verbose);
+    ~GameManager_315634022();
 
     GameResult run(
         size_t map_width, size_t map_height,
@@ -51,6 +55,16 @@ public:
         TankAlgorithmFactory fac2
     ) override;
 
+    // Plays every game on `map` in lockstep, one turn of each at a time;
+    // run() is a batch of one.
+    std::vector<GameResult> runBatch(
+        size_t map_width, size_t map_height,
+        const SatelliteView& map,
+        std::string map_name,
+        size_t max_steps, size_t num_shells,
+        const std::vector<UserCommon_315634022::BatchGame>& games
+    ) override;
+
     // 8‐way directions
     enum Dir8 { N = 0, NE, E, SE, S, SW, W, NW };
 
@@ -58,41 +72,13 @@ public:
     static constexpr int DX[8] = {  0,  1,  1,  1,  0, -1, -1, -1 };
     static constexpr int DY[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
 
-    // make these public so external code can alias them if desired
-    struct Tank {
-        int x, y;
-        Dir8 dir;
-        int shells;
-        bool alive;
-        std::unique_ptr<TankAlgorithm> alg;
-    };
-
-    struct Bullet {
-        int x, y;
-        Dir8 dir;
-        int owner;   // 0 or 1
-        bool active;
-    };
-
 private:
     bool verbose_;
-    std::vector<Tank>   tanks_;
-    std::vector<Bullet> bullets_;
-    Player*             players_[2];
-    const SatelliteView* map_;
-    size_t              width_, height_;
-
-    void debug(const std::string& msg);
 
-    void initTanks(
-        size_t max_steps, size_t num_shells,
-        TankAlgorithmFactory fac1,
-        TankAlgorithmFactory fac2
-    );
-    void applyBulletMovement();
-    void resolveCollisions();
-    bool oneSideDead() const;
-    void advanceOneTurn();
+    // The engine of the last runBatch(): one of the fixed-size instances
+    // when the map fits one, else the generic engine. Kept until the next
+    // run, since the results' gameState views point into it.
+    std::unique_ptr<EngineBase> engine_;
 };
 
 } // namespace GameManager_315634022
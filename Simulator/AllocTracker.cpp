@@ -0,0 +1,232 @@
+#include "AllocTracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <ostream>
+#include <string>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr auto relaxed = std::memory_order_relaxed;
+
+// what this thread's allocations are charged to; null outside games
+thread_local GameAllocStats* tlsGame      = nullptr;
+thread_local AllocCounters*  tlsBucket    = nullptr;
+thread_local int             tlsCallDepth = 0;
+
+inline std::size_t usableSize(void* p) {
+#if defined(__APPLE__)
+    return malloc_size(p);
+#else
+    return malloc_usable_size(p);
+#endif
+}
+
+// nothing here may allocate: it runs inside operator new
+inline void noteAlloc(void* p) {
+    GameAllocStats* g = tlsGame;
+    if (!g) return;
+    const std::int64_t n = std::int64_t(usableSize(p));
+    tlsBucket->allocations.fetch_add(1, relaxed);
+    tlsBucket->bytes.fetch_add(std::uint64_t(n), relaxed);
+    const std::int64_t live = g->live.fetch_add(n, relaxed) + n;
+    std::int64_t peak = g->peakLive.load(relaxed);
+    while (live > peak && !g->peakLive.compare_exchange_weak(peak, live, relaxed)) {}
+}
+
+inline void noteFree(void* p) {
+    if (GameAllocStats* g = tlsGame)
+        if (p) g->live.fetch_sub(std::int64_t(usableSize(p)), relaxed);
+}
+
+void* allocate(std::size_t n, std::size_t align, bool nothrow) {
+    if (n == 0) n = 1;
+    for (;;) {
+        void* p = nullptr;
+        if (align <= alignof(std::max_align_t)) p = std::malloc(n);
+        else if (posix_memalign(&p, std::max(align, sizeof(void*)), n) != 0) p = nullptr;
+        if (p) {
+            noteAlloc(p);
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            if (nothrow) return nullptr;
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+inline void release(void* p) {
+    noteFree(p);
+    std::free(p);
+}
+
+double seconds(std::uint64_t nanos) { return double(nanos) / 1e9; }
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// Replacement allocation functions, every form the standard lets a program
+// replace
+//------------------------------------------------------------------------------
+void* operator new(std::size_t n)   { return allocate(n, 0, false); }
+void* operator new[](std::size_t n) { return allocate(n, 0, false); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept   { return allocate(n, 0, true); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return allocate(n, 0, true); }
+void* operator new(std::size_t n, std::align_val_t a)   { return allocate(n, std::size_t(a), false); }
+void* operator new[](std::size_t n, std::align_val_t a) { return allocate(n, std::size_t(a), false); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return allocate(n, std::size_t(a), true);
+}
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept {
+    return allocate(n, std::size_t(a), true);
+}
+
+void operator delete(void* p) noexcept                          { release(p); }
+void operator delete[](void* p) noexcept                        { release(p); }
+void operator delete(void* p, std::size_t) noexcept             { release(p); }
+void operator delete[](void* p, std::size_t) noexcept           { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept   { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept                { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept   { release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+
+//------------------------------------------------------------------------------
+// Scopes
+//------------------------------------------------------------------------------
+GameScope::GameScope(GameAllocStats* stats)
+  : stats_(stats), prevGame_(tlsGame), prevBucket_(tlsBucket)
+{
+    if (!stats_) return;
+    tlsGame   = stats_;
+    tlsBucket = &stats_->engine;
+    start_    = Clock::now();
+}
+
+GameScope::~GameScope() {
+    if (!stats_) return;
+    stats_->wall += Clock::now() - start_;
+    tlsGame   = prevGame_;
+    tlsBucket = prevBucket_;
+}
+
+PluginCall::PluginCall(GameAllocStats& stats, int side)
+  : outer_(tlsCallDepth++ == 0)
+{
+    if (!outer_) return;
+    prevGame_   = tlsGame;
+    prevBucket_ = tlsBucket;
+    bucket_     = &stats.side[side];
+    tlsGame     = &stats;
+    tlsBucket   = bucket_;
+    start_      = Clock::now();
+}
+
+PluginCall::~PluginCall() {
+    --tlsCallDepth;
+    if (!outer_) return;
+    auto spent = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_);
+    bucket_->nanos.fetch_add(std::uint64_t(spent.count()), relaxed);
+    tlsGame   = prevGame_;
+    tlsBucket = prevBucket_;
+}
+
+TankAlgorithmFactory trackTanks(GameAllocStats* stats, int side, TankAlgorithmFactory make) {
+    if (!stats) return make;
+    return [stats, side, make = std::move(make)](int pi, int ti) -> std::unique_ptr<TankAlgorithm> {
+        std::unique_ptr<TankAlgorithm> tank;
+        {
+            PluginCall c(*stats, side);
+            tank = make(pi, ti);
+        }
+        return std::make_unique<TimedTankAlgorithm>(std::move(tank), *stats, side);
+    };
+}
+
+//------------------------------------------------------------------------------
+// Report
+//------------------------------------------------------------------------------
+AllocSummary summarize(const GameAllocStats& s) {
+    AllocSummary a;
+    a.valid             = true;
+    a.engineAllocations = s.engine.allocations.load();
+    a.engineBytes       = s.engine.bytes.load();
+    a.allocations       = a.engineAllocations;
+    a.bytes             = a.engineBytes;
+    double plugins = 0;
+    for (int k = 0; k < 2; ++k) {
+        a.sideAllocations[k] = s.side[k].allocations.load();
+        a.sideBytes[k]       = s.side[k].bytes.load();
+        a.sideSeconds[k]     = seconds(s.side[k].nanos.load());
+        a.allocations       += a.sideAllocations[k];
+        a.bytes             += a.sideBytes[k];
+        plugins             += a.sideSeconds[k];
+    }
+    a.peakLive = std::uint64_t(std::max<std::int64_t>(0, s.peakLive.load()));
+    // decision threads can make plugin time exceed the game's wall time
+    a.engineSeconds = std::max(0.0, std::chrono::duration<double>(s.wall).count() - plugins);
+    return a;
+}
+
+void printAllocationReport(std::ostream& out, const std::vector<CompetitionRow>& rows,
+                           const std::vector<AllocSummary>& allocs) {
+    struct Total {
+        std::size_t   games = 0;
+        std::uint64_t allocations = 0, bytes = 0, peakLive = 0;
+        double        seconds = 0;
+    };
+    std::map<std::string, Total> perAlgo;
+    const auto flags = out.flags();
+    const auto prec  = out.precision();
+    out << std::fixed << std::setprecision(6);
+
+    out << "[Simulator] Allocations: (per game; engine = outside plugin calls)\n";
+    for (std::size_t r = 0; r < rows.size() && r < allocs.size(); ++r) {
+        const AllocSummary& a = allocs[r];
+        if (!a.valid) continue;
+        const CompetitionRow& row = rows[r];
+        out << "  map=" << row.mapFile << "  A1=" << row.a1 << "  A2=" << row.a2
+            << " => allocs=" << a.allocations << "  bytes=" << a.bytes
+            << "  peak_live=" << a.peakLive
+            << " | engine allocs=" << a.engineAllocations << " bytes=" << a.engineBytes
+            << " time=" << a.engineSeconds << "s";
+        const std::string* names[2] = {&row.a1, &row.a2};
+        for (int k = 0; k < 2; ++k) {
+            out << " | A" << (k + 1) << " allocs=" << a.sideAllocations[k]
+                << " bytes=" << a.sideBytes[k] << " time=" << a.sideSeconds[k] << "s";
+            Total& t = perAlgo[*names[k]];
+            ++t.games;
+            t.allocations += a.sideAllocations[k];
+            t.bytes       += a.sideBytes[k];
+            t.seconds     += a.sideSeconds[k];
+            t.peakLive     = std::max(t.peakLive, a.peakLive);
+        }
+        out << "\n";
+    }
+
+    out << "[Simulator] Allocations per algorithm: (inside its own plugin calls)\n";
+    for (auto& [name, t] : perAlgo) {
+        out << "  " << name << "  games=" << t.games
+            << "  allocs=" << t.allocations << "  bytes=" << t.bytes
+            << "  time=" << t.seconds << "s"
+            << "  bytes/game=" << (t.bytes / t.games)
+            << "  max_game_peak_live=" << t.peakLive << "\n";
+    }
+    out.flags(flags);
+    out.precision(prec);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CompetitionReport.hpp"
+#include "Player.h"
+#include "TankAlgorithm.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Memory and time accounting per game (--alloc_stats). The simulator replaces
+// the global operator new/delete, and plugins bind to the executable's copies.
+// While a thread plays a game (GameScope) or runs one of its plugin calls
+// (PluginCall), each allocation it makes is charged to the game: to the
+// plugin whose call is running, or to the engine outside plugin calls.
+// Sizes are as malloc rounds them. Live bytes drop on whichever thread frees,
+// so a game's peak counts what its own threads hold, relative to its start.
+// Threads outside those scopes pay one thread-local load per allocation.
+struct AllocCounters {
+    std::atomic<std::uint64_t> allocations{0}, bytes{0};
+    std::atomic<std::uint64_t> nanos{0};   // inside plugin calls; unused for the engine
+};
+
+struct GameAllocStats {
+    AllocCounters engine;
+    AllocCounters side[2];   // player 1's and player 2's plugin
+    std::atomic<std::int64_t> live{0}, peakLive{0};
+    std::chrono::steady_clock::duration wall{};
+};
+
+// Charges this thread's allocations to the engine of `stats` and times the
+// game, until destroyed. A null `stats` does nothing.
+class GameScope {
+public:
+    explicit GameScope(GameAllocStats* stats);
+    ~GameScope();
+    GameScope(const GameScope&) = delete;
+    GameScope& operator=(const GameScope&) = delete;
+private:
+    GameAllocStats* stats_;
+    GameAllocStats* prevGame_;
+    AllocCounters*  prevBucket_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// A call into player `side`'s plugin, on any thread: its allocations and time
+// go to that side. Calls nest (a player handing info to its tank); the
+// outermost one counts.
+class PluginCall {
+public:
+    PluginCall(GameAllocStats& stats, int side);
+    ~PluginCall();
+    PluginCall(const PluginCall&) = delete;
+    PluginCall& operator=(const PluginCall&) = delete;
+private:
+    bool            outer_;
+    GameAllocStats* prevGame_   = nullptr;
+    AllocCounters*  prevBucket_ = nullptr;
+    AllocCounters*  bucket_     = nullptr;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Proxies that run every call of a plugin object as a PluginCall.
+class TimedTankAlgorithm : public TankAlgorithm {
+public:
+    TimedTankAlgorithm(std::unique_ptr<TankAlgorithm> inner, GameAllocStats& stats, int side)
+      : inner_(std::move(inner)), stats_(stats), side_(side) {}
+    ~TimedTankAlgorithm() override { PluginCall c(stats_, side_); inner_.reset(); }
+    ActionRequest getAction() override { PluginCall c(stats_, side_); return inner_->getAction(); }
+    void updateBattleInfo(BattleInfo& info) override {
+        PluginCall c(stats_, side_);
+        inner_->updateBattleInfo(info);
+    }
+private:
+    std::unique_ptr<TankAlgorithm> inner_;
+    GameAllocStats& stats_;
+    const int side_;
+};
+
+class TimedPlayer : public Player {
+public:
+    TimedPlayer(std::unique_ptr<Player> inner, GameAllocStats& stats, int side)
+      : inner_(std::move(inner)), stats_(stats), side_(side) {}
+    ~TimedPlayer() override { PluginCall c(stats_, side_); inner_.reset(); }
+    void updateTankWithBattleInfo(TankAlgorithm& tank, SatelliteView& view) override {
+        PluginCall c(stats_, side_);
+        inner_->updateTankWithBattleInfo(tank, view);
+    }
+private:
+    std::unique_ptr<Player> inner_;
+    GameAllocStats& stats_;
+    const int side_;
+};
+
+// make() wrapped for accounting when `stats` is set, as is otherwise.
+template <class Make>
+std::unique_ptr<Player> trackPlayer(GameAllocStats* stats, int side, Make make) {
+    if (!stats) return make();
+    std::unique_ptr<Player> p;
+    {
+        PluginCall c(*stats, side);
+        p = make();
+    }
+    return std::make_unique<TimedPlayer>(std::move(p), *stats, side);
+}
+TankAlgorithmFactory trackTanks(GameAllocStats* stats, int side, TankAlgorithmFactory make);
+
+// A finished game's counters, copied out for the report.
+struct AllocSummary {
+    bool          valid = false;   // false: the game was not played here
+    std::uint64_t allocations = 0, bytes = 0, peakLive = 0;
+    std::uint64_t engineAllocations = 0, engineBytes = 0;
+    std::uint64_t sideAllocations[2] = {0, 0}, sideBytes[2] = {0, 0};
+    double        engineSeconds = 0, sideSeconds[2] = {0, 0};
+};
+AllocSummary summarize(const GameAllocStats& stats);
+
+// Per-game lines for the rows that have a summary, then totals per algorithm
+// over its own plugin calls. `allocs` is parallel to `rows`.
+void printAllocationReport(std::ostream& out, const std::vector<CompetitionRow>& rows,
+                           const std::vector<AllocSummary>& allocs);
@@ -1,6 +1,9 @@
 #include "ArgParser.hpp"
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <set>
 #include <algorithm>
 
 namespace fs = std::filesystem;
@@ -13,27 +16,96 @@ void printUsage(const char* prog) {
               << "      game_managers_folder=<dir> \\\n"
               << "      algorithm1=<so> \\\n"
               << "      algorithm2=<so> \\\n"
-              << "      [num_threads=<N>] [--verbose]\n\n"
+              << "      [result_cache=<file> [--rerun]] \\\n"
+              << "      [profile=<file> [profile_hz=<N>]] \\\n"
+              << "      [num_threads=<N>|auto] [--pin_threads] [decision_threads=<N>] [--verbose]\n\n"
               << "  Competition mode:\n"
               << "    " << prog << " --competition \\\n"
               << "      game_maps_folder=<dir> \\\n"
               << "      game_manager=<so> \\\n"
               << "      algorithms_folder=<dir> \\\n"
-              << "      [num_threads=<N>] [--verbose]\n";
+              << "      [journal=<file>] [resume=<file>] \\\n"
+              << "      [shard=<i>/<n> [shard_output=<file>]] [batch_size=<K>] \\\n"
+              << "      [max_resident_maps=<N>] [progress=<sec>] [metrics_file=<file>] \\\n"
+              << "      [pairing=all|swiss [swiss_rounds=<R>]] [early_stop=<confidence>] \\\n"
+              << "      [--alloc_stats] \\\n"
+              << "      [result_cache=<file> [--rerun]] [profile=<file> [profile_hz=<N>]] \\\n"
+              << "      [num_threads=<N>|auto] [--pin_threads] [decision_threads=<N>] [--verbose]\n\n"
+              << "  Batch of runs (one per manifest line, each with output=<file>):\n"
+              << "    " << prog << " --batch=<manifest> \\\n"
+              << "      [profile=<file> [profile_hz=<N>]] \\\n"
+              << "      [num_threads=<N>|auto] [--pin_threads] [decision_threads=<N>]\n\n"
+              << "  Daemon (match requests on a Unix socket, see README):\n"
+              << "    " << prog << " --serve=<socket> \\\n"
+              << "      game_managers_folder=<dir> \\\n"
+              << "      algorithms_folder=<dir> \\\n"
+              << "      [result_cache=<file> [--rerun]] [profile=<file> [profile_hz=<N>]] \\\n"
+              << "      [num_threads=<N>|auto] [--pin_threads] [decision_threads=<N>]\n";
 }
 
 static std::string stripKey(const std::string& arg, const std::string& key) {
     return arg.substr(key.size());
 }
 
+// The whole of `text` as a number; false if it is not one (or out of range)
+static bool parseNumber(const std::string& text, int& out) {
+    try {
+        size_t used = 0;
+        int v = std::stoi(text, &used);
+        if (used != text.size()) return false;
+        out = v;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+static bool parseNumber(const std::string& text, double& out) {
+    try {
+        size_t used = 0;
+        double v = std::stod(text, &used);
+        if (used != text.size()) return false;
+        out = v;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+// "i/n" with 0 <= i < n
+static bool parseShard(const std::string& spec, int& index, int& count) {
+    auto slash = spec.find('/');
+    if (slash == std::string::npos) return false;
+    try {
+        size_t used = 0;
+        index = std::stoi(spec.substr(0, slash), &used);
+        if (used != slash) return false;
+        count = std::stoi(spec.substr(slash + 1), &used);
+        if (used != spec.size() - slash - 1) return false;
+    } catch (const std::exception&) {
+        return false;
+    }
+    return count >= 1 && index >= 0 && index < count;
+}
+
 bool parseArguments(int argc, char* argv[], Config& cfg) {
-    std::vector<std::string> unsupported;
+    std::vector<std::string> unsupported, malformed;
+    auto number = [&](const std::string& arg, const std::string& key, auto& out) {
+        if (!parseNumber(stripKey(arg, key), out)) malformed.push_back(arg);
+    };
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if      (arg == "--comparative")            cfg.modeComparative = true;
         else if (arg == "--competition")             cfg.modeCompetition = true;
         else if (arg == "--verbose")                 cfg.verbose = true;
-        else if (arg.rfind("num_threads=", 0) == 0)  cfg.numThreads = std::stoi(stripKey(arg, "num_threads="));
+        else if (arg == "--pin_threads")             cfg.pinThreads = true;
+        else if (arg == "--rerun")                   cfg.rerun = true;
+        else if (arg == "--alloc_stats")             cfg.allocStats = true;
+        else if (arg.rfind("--batch=",0) == 0)        cfg.batchManifest = stripKey(arg, "--batch=");
+        else if (arg.rfind("--serve=",0) == 0)        cfg.serveSocket = stripKey(arg, "--serve=");
+        else if (arg == "num_threads=auto")          cfg.numThreads = 0;
+        else if (arg.rfind("num_threads=", 0) == 0)  number(arg, "num_threads=", cfg.numThreads);
+        else if (arg.rfind("decision_threads=",0)==0) number(arg, "decision_threads=", cfg.decisionThreads);
         else if (arg.rfind("game_map=", 0) == 0)      cfg.game_map = stripKey(arg, "game_map=");
         else if (arg.rfind("game_managers_folder=",0)==0) cfg.game_managers_folder = stripKey(arg, "game_managers_folder=");
         else if (arg.rfind("algorithm1=",0) == 0)     cfg.algorithm1 = stripKey(arg, "algorithm1=");
@@ -41,10 +113,30 @@ bool parseArguments(int argc, char* argv[], Config& cfg) {
         else if (arg.rfind("game_maps_folder=",0)==0) cfg.game_maps_folder = stripKey(arg, "game_maps_folder=");
         else if (arg.rfind("game_manager=",0) == 0)   cfg.game_manager = stripKey(arg, "game_manager=");
         else if (arg.rfind("algorithms_folder=",0)==0)cfg.algorithms_folder = stripKey(arg, "algorithms_folder=");
+        else if (arg.rfind("journal=",0) == 0)        cfg.journal = stripKey(arg, "journal=");
+        else if (arg.rfind("resume=",0) == 0)         cfg.resume = stripKey(arg, "resume=");
+        else if (arg.rfind("shard_output=",0) == 0)   cfg.shard_output = stripKey(arg, "shard_output=");
+        else if (arg.rfind("batch_size=",0) == 0)     number(arg, "batch_size=", cfg.batchSize);
+        else if (arg.rfind("max_resident_maps=",0)==0) number(arg, "max_resident_maps=", cfg.maxResidentMaps);
+        else if (arg.rfind("progress=",0) == 0)       number(arg, "progress=", cfg.progressSeconds);
+        else if (arg.rfind("metrics_file=",0) == 0)   cfg.metricsFile = stripKey(arg, "metrics_file=");
+        else if (arg.rfind("result_cache=",0) == 0)   cfg.resultCache = stripKey(arg, "result_cache=");
+        else if (arg.rfind("profile=",0) == 0)        cfg.profileFile = stripKey(arg, "profile=");
+        else if (arg.rfind("profile_hz=",0) == 0)     number(arg, "profile_hz=", cfg.profileHz);
+        else if (arg == "pairing=all")               cfg.swissPairing = false;
+        else if (arg == "pairing=swiss")             cfg.swissPairing = true;
+        else if (arg.rfind("swiss_rounds=",0) == 0)   number(arg, "swiss_rounds=", cfg.swissRounds);
+        else if (arg.rfind("early_stop=",0) == 0)     number(arg, "early_stop=", cfg.earlyStop);
+        else if (arg.rfind("shard=",0) == 0) {
+            if (!parseShard(stripKey(arg, "shard="), cfg.shardIndex, cfg.shardCount)) {
+                std::cerr << "Error: shard= expects <i>/<n> with 0 <= i < n, got '" << arg << "'\n";
+                return false;
+            }
+        }
         else                                         unsupported.push_back(arg);
     }
 
-    // 1) Unsupported
+    // 1) Unsupported, or a number that is not one
     if (!unsupported.empty()) {
         std::cerr << "Error: unsupported arguments:";
         for (auto& u : unsupported) std::cerr << " " << u;
@@ -52,15 +144,107 @@ bool parseArguments(int argc, char* argv[], Config& cfg) {
         printUsage(argv[0]);
         return false;
     }
+    if (!malformed.empty()) {
+        std::cerr << "Error: not a number:";
+        for (auto& m : malformed) std::cerr << " " << m;
+        std::cerr << "\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
 
-    // 2) Exactly one mode
+    // 2) The profiler samples the whole process, whatever it runs
+    if (cfg.profileHz != 199 && cfg.profileFile.empty()) {
+        std::cerr << "Error: profile_hz= needs profile=\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.profileHz < 1 || cfg.profileHz > 10000) {
+        std::cerr << "Error: profile_hz= must be between 1 and 10000\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+
+    // 3) A batch takes its runs from the manifest; only the shared pool and
+    // the profiler are set here
+    if (!cfg.batchManifest.empty()) {
+        Config plain;
+        plain.numThreads      = cfg.numThreads;
+        plain.pinThreads      = cfg.pinThreads;
+        plain.decisionThreads = cfg.decisionThreads;
+        plain.batchManifest   = cfg.batchManifest;
+        if (plain.numThreads < 0) {
+            std::cerr << "Error: num_threads= must be a positive count or auto\n\n";
+            printUsage(argv[0]);
+            return false;
+        }
+        if (cfg.modeComparative || cfg.modeCompetition || cfg.verbose || cfg.rerun ||
+            !cfg.serveSocket.empty() ||
+            !cfg.resultCache.empty() || !cfg.game_map.empty() || !cfg.game_managers_folder.empty() ||
+            !cfg.algorithm1.empty() || !cfg.algorithm2.empty() || !cfg.game_maps_folder.empty() ||
+            !cfg.game_manager.empty() || !cfg.algorithms_folder.empty() || !cfg.journal.empty() ||
+            !cfg.resume.empty() || cfg.shardCount > 1 || !cfg.shard_output.empty() ||
+            cfg.batchSize != 1 || cfg.maxResidentMaps != 0 || cfg.progressSeconds != 0 ||
+            !cfg.metricsFile.empty() || cfg.swissPairing || cfg.swissRounds != 0 ||
+            cfg.earlyStop != 0 || cfg.allocStats) {
+            std::cerr << "Error: with --batch= only num_threads=/--pin_threads/decision_threads=/"
+                         "profile=/profile_hz= go on the command line; the rest goes on the "
+                         "manifest lines\n\n";
+            printUsage(argv[0]);
+            return false;
+        }
+        if (!fs::is_regular_file(cfg.batchManifest)) {
+            std::cerr << "Error: batch manifest not a file: " << cfg.batchManifest << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    // 4) The daemon plays what it is asked; it only needs the plugin folders
+    if (!cfg.serveSocket.empty()) {
+        if (cfg.modeComparative || cfg.modeCompetition || cfg.verbose ||
+            !cfg.game_map.empty() || !cfg.algorithm1.empty() || !cfg.algorithm2.empty() ||
+            !cfg.game_maps_folder.empty() || !cfg.game_manager.empty() || !cfg.journal.empty() ||
+            !cfg.resume.empty() || cfg.shardCount > 1 || !cfg.shard_output.empty() ||
+            cfg.batchSize != 1 || cfg.maxResidentMaps != 0 || cfg.progressSeconds != 0 ||
+            !cfg.metricsFile.empty() || cfg.swissPairing || cfg.swissRounds != 0 ||
+            cfg.earlyStop != 0 || cfg.allocStats) {
+            std::cerr << "Error: --serve= takes game_managers_folder=/algorithms_folder=, "
+                         "result_cache=/--rerun, profile= and the thread options only\n\n";
+            printUsage(argv[0]);
+            return false;
+        }
+        if (cfg.game_managers_folder.empty() || cfg.algorithms_folder.empty()) {
+            std::cerr << "Error: --serve= needs game_managers_folder= and algorithms_folder=\n\n";
+            printUsage(argv[0]);
+            return false;
+        }
+        if (cfg.numThreads < 0) {
+            std::cerr << "Error: num_threads= must be a positive count or auto\n\n";
+            printUsage(argv[0]);
+            return false;
+        }
+        if (cfg.rerun && cfg.resultCache.empty()) {
+            std::cerr << "Error: --rerun needs result_cache=\n\n";
+            printUsage(argv[0]);
+            return false;
+        }
+        for (auto* dir : {&cfg.game_managers_folder, &cfg.algorithms_folder}) {
+            if (!fs::is_directory(*dir)) {
+                std::cerr << "Error: not a directory: " << *dir << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 5) Exactly one mode
     if (cfg.modeComparative == cfg.modeCompetition) {
         std::cerr << "Error: must specify exactly one of --comparative or --competition\n\n";
         printUsage(argv[0]);
         return false;
     }
 
-    // 3) Required args
+    // 6) Required args
     std::vector<std::string> missing;
     if (cfg.modeComparative) {
         if (cfg.game_map.empty())               missing.push_back("game_map");
@@ -72,6 +256,64 @@ bool parseArguments(int argc, char* argv[], Config& cfg) {
         if (cfg.game_manager.empty())           missing.push_back("game_manager");
         if (cfg.algorithms_folder.empty())      missing.push_back("algorithms_folder");
     }
+    if (cfg.modeComparative && (!cfg.journal.empty() || !cfg.resume.empty() ||
+                                cfg.shardCount > 1 || !cfg.shard_output.empty() ||
+                                cfg.batchSize != 1 || cfg.maxResidentMaps != 0 ||
+                                cfg.progressSeconds != 0 || !cfg.metricsFile.empty() ||
+                                cfg.swissPairing || cfg.swissRounds != 0 || cfg.earlyStop != 0 ||
+                                cfg.allocStats)) {
+        std::cerr << "Error: journal=/resume=/shard=/shard_output=/batch_size=/max_resident_maps=/"
+                     "progress=/metrics_file=/pairing=/swiss_rounds=/early_stop=/--alloc_stats "
+                     "are competition-only\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.swissRounds != 0 && !cfg.swissPairing) {
+        std::cerr << "Error: swiss_rounds= needs pairing=swiss\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.swissRounds < 0) {
+        std::cerr << "Error: swiss_rounds= must not be negative\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.earlyStop != 0 && !(cfg.earlyStop > 0.5 && cfg.earlyStop < 1)) {
+        std::cerr << "Error: early_stop= expects a confidence between 0.5 and 1 (exclusive)\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    // each round's pairs depend on the ratings after the last one: no slicing
+    if (cfg.swissPairing && (cfg.shardCount > 1 || !cfg.shard_output.empty())) {
+        std::cerr << "Error: pairing=swiss cannot be sharded\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.rerun && cfg.resultCache.empty()) {
+        std::cerr << "Error: --rerun needs result_cache=\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.numThreads < 0) {
+        std::cerr << "Error: num_threads= must be a positive count or auto\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.batchSize < 1) {
+        std::cerr << "Error: batch_size= must be at least 1\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.progressSeconds < 0) {
+        std::cerr << "Error: progress= must not be negative\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
+    if (cfg.maxResidentMaps < 0) {
+        std::cerr << "Error: max_resident_maps= must not be negative\n\n";
+        printUsage(argv[0]);
+        return false;
+    }
     if (!missing.empty()) {
         std::cerr << "Error: missing arguments:";
         for (auto& m : missing) std::cerr << " " << m;
@@ -80,7 +322,7 @@ bool parseArguments(int argc, char* argv[], Config& cfg) {
         return false;
     }
 
-    // 4) Existence checks
+    // 7) Existence checks
     auto mustBeDir = [&](const std::string& path, const char* name){
         if (!fs::is_directory(path)) {
             std::cerr << "Error: " << name << " not a directory: " << path << "\n";
@@ -126,3 +368,53 @@ bool parseArguments(int argc, char* argv[], Config& cfg) {
 
     return true;
 }
+
+bool parseManifest(const Config& batch, const char* prog, std::vector<BatchJob>& jobs) {
+    std::ifstream in(batch.batchManifest);
+    if (!in) {
+        std::cerr << "Error: cannot read batch manifest: " << batch.batchManifest << "\n";
+        return false;
+    }
+    auto fail = [&](size_t line, const std::string& what) {
+        std::cerr << "Error: " << batch.batchManifest << ":" << line << ": " << what << "\n";
+        return false;
+    };
+
+    std::set<std::string> outputs;
+    std::string text;
+    for (size_t line = 1; std::getline(in, text); ++line) {
+        std::istringstream words(text);
+        std::vector<std::string> args{prog};
+        std::string word, output;
+        while (words >> word) {
+            if (word[0] == '#') break;
+            if (word.rfind("output=", 0) == 0) { output = stripKey(word, "output="); continue; }
+            if (word.rfind("num_threads=", 0) == 0 || word.rfind("decision_threads=", 0) == 0 ||
+                word == "--pin_threads" || word.rfind("--batch=", 0) == 0 ||
+                word.rfind("--serve=", 0) == 0 || word.rfind("profile=", 0) == 0 ||
+                word.rfind("profile_hz=", 0) == 0)
+                return fail(line, "'" + word + "' belongs on the command line, not in the manifest");
+            args.push_back(word);
+        }
+        if (args.size() == 1 && output.empty()) continue;   // blank or comment
+        if (output.empty())
+            return fail(line, "missing output=<file>");
+        if (!outputs.insert(output).second)
+            return fail(line, "output '" + output + "' is already written by an earlier job");
+
+        std::vector<char*> argv;
+        for (auto& a : args) argv.push_back(&a[0]);
+        BatchJob job{Config{}, output, line};
+        if (!parseArguments(int(argv.size()), argv.data(), job.cfg))
+            return fail(line, "bad job arguments (see above)");
+        job.cfg.numThreads      = batch.numThreads;
+        job.cfg.pinThreads      = batch.pinThreads;
+        job.cfg.decisionThreads = batch.decisionThreads;
+        jobs.push_back(std::move(job));
+    }
+    if (jobs.empty()) {
+        std::cerr << "Error: batch manifest lists no jobs: " << batch.batchManifest << "\n";
+        return false;
+    }
+    return true;
+}
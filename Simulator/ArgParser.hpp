@@ -7,7 +7,15 @@ struct Config {
     bool   modeComparative   = false;
     bool   modeCompetition   = false;
     bool   verbose           = false;
-    int    numThreads        = 1;
+    int    numThreads        = 1;   // 0 = num_threads=auto, resolved from the CPU topology
+    bool   pinThreads        = false;   // pin pool workers to CPUs, spread over NUMA nodes
+    int    decisionThreads   = 1;   // threads per game for the tanks' decisions
+    std::string resultCache;        // reuse results of games whose inputs are unchanged
+    bool   rerun             = false;   // ignore cached results (still store fresh ones)
+    std::string batchManifest;      // --batch=: run the jobs listed in this file
+    std::string serveSocket;        // --serve=: answer match requests on this Unix socket
+    std::string profileFile;        // profile=: sample the CPU, write folded stacks here
+    int    profileHz         = 199; // profile_hz=: samples per CPU-second
 
     // comparative-only
     std::string game_map;
@@ -19,10 +27,35 @@ struct Config {
     std::string game_maps_folder;
     std::string game_manager;
     std::string algorithms_folder;
+    std::string journal;   // append finished games here
+    std::string resume;    // skip games already in this journal (and keep appending to it)
+    int         shardIndex = 0;   // shard=i/n: run only slice i (0-based) of n
+    int         shardCount = 1;
+    std::string shard_output;     // partial result file for merge_shards
+    int         batchSize  = 1;   // games per map handed to the GM at once
+    int         maxResidentMaps = 0;   // parsed maps held at once, 0 = 2 × num_threads
+    double      progressSeconds = 0;   // status line on stderr every N seconds, 0 = off
+    std::string metricsFile;           // Prometheus text file, rewritten as progress goes
+    bool        swissPairing = false;  // pairing=swiss: rated Swiss rounds instead of all pairs
+    int         swissRounds  = 0;      // 0 = 2·ceil(log2 algorithms)
+    double      earlyStop    = 0;      // early_stop=<confidence>: stop decided pairs, 0 = off
+    bool        allocStats   = false;  // --alloc_stats: per-game allocations and plugin time
 };
 
 // Parses argv into cfg. On error, prints to stderr and returns false.
 bool parseArguments(int argc, char* argv[], Config& cfg);
 
+// One line of a --batch= manifest: the arguments of a plain run plus
+// output=<file> for its report.
+struct BatchJob {
+    Config      cfg;
+    std::string output;
+    size_t      line;   // in the manifest, for messages
+};
+
+// Parses the manifest named by batch.batchManifest into jobs, which inherit
+// the batch's thread settings. On error, prints to stderr and returns false.
+bool parseManifest(const Config& batch, const char* prog, std::vector<BatchJob>& jobs);
+
 // Prints usage to stderr.
 void printUsage(const char* prog);
@@ -0,0 +1,83 @@
+#include "CompetitionReport.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+void printCompetitionReport(std::ostream& out, const std::vector<CompetitionRow>& rows,
+                            const std::string& headerNote) {
+    out << "[Simulator] Competition Results:";
+    if (!headerNote.empty()) out << " " << headerNote;
+    out << "\n";
+    for (auto& r : rows) {
+        out << "  map=" << r.mapFile
+            << "  A1=" << r.a1
+            << "  A2=" << r.a2
+            << " => winner=" << r.winner
+            << "  reason=" << r.reason
+            << "  rounds=" << r.rounds << "\n";
+    }
+}
+
+void writeShardFile(const std::string& path, const ShardHeader& hdr,
+                    const std::vector<CompetitionRow>& rows) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open shard output: " + path);
+    }
+    // header, then <task> <winner> <reason> <rounds> <a1> <a2> <mapFile>, tab-separated
+    out << "#shard\t" << hdr.shardIndex << "\t" << hdr.shardCount
+        << "\t" << hdr.totalTasks << "\n";
+    for (auto& r : rows) {
+        out << r.task << '\t' << r.winner << '\t' << r.reason << '\t' << r.rounds << '\t'
+            << r.a1 << '\t' << r.a2 << '\t' << r.mapFile << '\n';
+    }
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed to write shard output: " + path);
+    }
+}
+
+std::vector<CompetitionRow> readShardFile(const std::string& path, ShardHeader& hdr) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open shard file: " + path);
+    }
+    std::string line;
+    if (!std::getline(in, line) || line.rfind("#shard\t", 0) != 0) {
+        throw std::runtime_error("Not a shard result file: " + path);
+    }
+    {
+        std::istringstream hs(line.substr(7));
+        if (!(hs >> hdr.shardIndex >> hdr.shardCount >> hdr.totalTasks)) {
+            throw std::runtime_error("Bad shard header in " + path);
+        }
+    }
+
+    std::vector<CompetitionRow> rows;
+    size_t lineNo = 1;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (line.empty()) continue;
+        std::vector<std::string> f;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t')) f.push_back(field);
+        if (f.size() != 7) {
+            std::ostringstream os;
+            os << path << ":" << lineNo << ": expected 7 fields, got " << f.size();
+            throw std::runtime_error(os.str());
+        }
+        CompetitionRow r;
+        r.task    = std::stoul(f[0]);
+        r.winner  = std::stoi(f[1]);
+        r.reason  = std::stoi(f[2]);
+        r.rounds  = std::stoul(f[3]);
+        r.a1      = f[4];
+        r.a2      = f[5];
+        r.mapFile = f[6];
+        rows.push_back(std::move(r));
+    }
+    return rows;
+}
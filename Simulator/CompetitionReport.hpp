@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// One competition game, identified by its index in the canonical
+// (map × algorithm-pair) matrix: maps and algorithms sorted by path,
+// maps outermost, then pairs i<j in order.
+struct CompetitionRow {
+    std::size_t task = 0;
+    std::string mapFile, a1, a2;
+    int         winner = 0;
+    int         reason = 0;
+    std::size_t rounds = 0;
+};
+
+// Prints the competition report; rows must be sorted by task.
+void printCompetitionReport(std::ostream& out, const std::vector<CompetitionRow>& rows,
+                            const std::string& headerNote = "");
+
+// Partial result file written by one shard of a sharded competition.
+struct ShardHeader {
+    std::size_t shardIndex = 0, shardCount = 1, totalTasks = 0;
+};
+
+// Writes/reads a partial result file. Both throw std::runtime_error on I/O or
+// format errors.
+void writeShardFile(const std::string& path, const ShardHeader& hdr,
+                    const std::vector<CompetitionRow>& rows);
+std::vector<CompetitionRow> readShardFile(const std::string& path, ShardHeader& hdr);
@@ -0,0 +1,142 @@
+#include "CpuTopology.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// "0-3,8,10-11" -> {0,1,2,3,8,10,11}; malformed pieces are skipped
+static std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> out;
+    std::stringstream ss(text);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        try {
+            auto dash = part.find('-');
+            int lo = std::stoi(part.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(part.substr(dash + 1));
+            for (int c = lo; c <= hi; ++c) out.push_back(c);
+        } catch (const std::exception&) {}
+    }
+    return out;
+}
+
+static std::string readFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+// cgroup v2 cpu.max ("max 100000" / "150000 100000"), else v1 cfs files
+static double readCgroupQuota() {
+    std::istringstream v2(readFirstLine("/sys/fs/cgroup/cpu.max"));
+    std::string quota, period;
+    if (v2 >> quota >> period) {
+        if (quota == "max") return 0;
+        try { return std::stod(quota) / std::stod(period); }
+        catch (const std::exception&) { return 0; }
+    }
+    try {
+        double q = std::stod(readFirstLine("/sys/fs/cgroup/cpu/cpu.cfs_quota_us"));
+        double p = std::stod(readFirstLine("/sys/fs/cgroup/cpu/cpu.cfs_period_us"));
+        return (q > 0 && p > 0) ? q / p : 0;
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology t;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) t.cpus.push_back(c);
+    }
+    t.quota = readCgroupQuota();
+#endif
+    if (t.cpus.empty()) {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned c = 0; c < n; ++c) t.cpus.push_back(int(c));
+    }
+
+    t.nodes.assign(t.cpus.size(), 0);
+#ifdef __linux__
+    std::error_code ec;
+    for (auto& e : fs::directory_iterator("/sys/devices/system/node", ec)) {
+        std::string name = e.path().filename().string();
+        if (name.rfind("node", 0) != 0) continue;
+        int node;
+        try { node = std::stoi(name.substr(4)); }
+        catch (const std::exception&) { continue; }
+        for (int c : parseCpuList(readFirstLine((e.path() / "cpulist").string()))) {
+            auto it = std::lower_bound(t.cpus.begin(), t.cpus.end(), c);
+            if (it != t.cpus.end() && *it == c) t.nodes[it - t.cpus.begin()] = node;
+        }
+    }
+#endif
+    return t;
+}
+
+std::size_t CpuTopology::usableThreads() const {
+    std::size_t n = cpus.size();
+    if (quota > 0) n = std::min(n, std::size_t(std::ceil(quota)));
+    return std::max<std::size_t>(n, 1);
+}
+
+std::size_t CpuTopology::nodeCount() const {
+    std::vector<int> distinct(nodes);
+    std::sort(distinct.begin(), distinct.end());
+    return std::size_t(std::unique(distinct.begin(), distinct.end()) - distinct.begin());
+}
+
+std::vector<int> CpuTopology::pinOrder(std::size_t n) const {
+    std::vector<int> ids(nodes);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    std::vector<std::vector<int>> perNode(ids.size());
+    for (std::size_t i = 0; i < cpus.size(); ++i) {
+        auto k = std::lower_bound(ids.begin(), ids.end(), nodes[i]) - ids.begin();
+        perNode[k].push_back(cpus[i]);
+    }
+
+    std::vector<int> order;
+    for (std::size_t round = 0; order.size() < cpus.size(); ++round)
+        for (auto& list : perNode)
+            if (round < list.size()) order.push_back(list[round]);
+
+    std::vector<int> out;
+    for (std::size_t i = 0; i < n && !order.empty(); ++i)
+        out.push_back(order[i % order.size()]);
+    return out;
+}
+
+int CpuTopology::nodeOf(int cpu) const {
+    auto it = std::lower_bound(cpus.begin(), cpus.end(), cpu);
+    return (it != cpus.end() && *it == cpu) ? nodes[it - cpus.begin()] : 0;
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// What the simulator may run on: the CPUs in this process's affinity mask,
+// the NUMA node of each, and the CPU quota of its cgroup. Linux reads these
+// from sched_getaffinity() and /sys; elsewhere every hardware thread counts
+// and there is a single node, no quota and no pinning.
+struct CpuTopology {
+    std::vector<int> cpus;    // allowed CPU ids, ascending
+    std::vector<int> nodes;   // NUMA node of cpus[i]
+    double           quota = 0;   // cgroup CPU limit in CPUs, 0 = none
+
+    static CpuTopology detect();
+
+    // Threads worth running: allowed CPUs, capped by the quota (rounded up).
+    std::size_t usableThreads() const;
+
+    // Number of distinct nodes among `cpus`.
+    std::size_t nodeCount() const;
+
+    // CPUs for `n` pinned workers: spread round-robin over the nodes so every
+    // node gets a share, and over each node's CPUs in order.
+    std::vector<int> pinOrder(std::size_t n) const;
+
+    // Node of CPU id `cpu`, 0 if unknown.
+    int nodeOf(int cpu) const;
+};
+
+// Restricts the calling thread to `cpu`. False where unsupported or refused.
+bool pinCurrentThread(int cpu);
@@ -0,0 +1,291 @@
+#include "Daemon.hpp"
+#include "Hashing.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+bool parseRequest(const std::string& payload, MatchRequest& req, std::string& error) {
+    std::istringstream in(payload);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos) { error = "expected key=value, got '" + line + "'"; return false; }
+        const std::string key = line.substr(0, eq), value = line.substr(eq + 1);
+        try {
+            if      (key == "id")         req.id = value;
+            else if (key == "map")        req.map = value;
+            else if (key == "gm")         req.gm = value;
+            else if (key == "algorithm1") req.algorithm1 = value;
+            else if (key == "algorithm2") req.algorithm2 = value;
+            else if (key == "max_steps")  req.maxSteps = std::stol(value);
+            else if (key == "num_shells") req.numShells = std::stol(value);
+            else { error = "unknown key '" + key + "'"; return false; }
+        } catch (const std::exception&) {
+            error = "bad number in '" + line + "'";
+            return false;
+        }
+    }
+    std::string missing;
+    if (req.map.empty())        missing += " map";
+    if (req.gm.empty())         missing += " gm";
+    if (req.algorithm1.empty()) missing += " algorithm1";
+    if (req.algorithm2.empty()) missing += " algorithm2";
+    if (!missing.empty()) { error = "missing" + missing; return false; }
+    if (req.maxSteps < -1 || req.numShells < -1) { error = "max_steps/num_shells must not be negative"; return false; }
+    return true;
+}
+
+std::string encodeReply(const MatchReply& r) {
+    std::ostringstream os;
+    os << "id=" << r.id << '\n';
+    if (!r.error.empty()) {
+        std::string msg = r.error;
+        for (char& c : msg) if (c == '\n') c = ' ';
+        os << "status=error\nerror=" << msg << '\n';
+        return os.str();
+    }
+    os << "status=ok\n"
+       << "winner=" << r.winner << '\n'
+       << "reason=" << r.reason << '\n'
+       << "rounds=" << r.rounds << '\n'
+       << "state="  << toHex(r.stateHash) << '\n'
+       << "cached=" << (r.cached ? 1 : 0) << '\n';
+    return os.str();
+}
+
+static bool readAll(int fd, char* p, std::size_t n) {
+    while (n > 0) {
+        ssize_t got = ::read(fd, p, n);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        p += got;
+        n -= std::size_t(got);
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        ssize_t put = ::write(fd, p, n);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        p += put;
+        n -= std::size_t(put);
+    }
+    return true;
+}
+
+bool readFrame(int fd, std::string& payload) {
+    unsigned char len[4];
+    if (!readAll(fd, reinterpret_cast<char*>(len), 4)) return false;
+    const std::size_t n = (std::size_t(len[0]) << 24) | (std::size_t(len[1]) << 16) |
+                          (std::size_t(len[2]) << 8)  |  std::size_t(len[3]);
+    if (n > kMaxFrameBytes) return false;
+    payload.resize(n);
+    return readAll(fd, &payload[0], n);
+}
+
+bool writeFrame(int fd, const std::string& payload) {
+    const std::size_t n = payload.size();
+    std::string frame;
+    frame.reserve(4 + n);
+    frame += char((n >> 24) & 0xff);
+    frame += char((n >> 16) & 0xff);
+    frame += char((n >> 8) & 0xff);
+    frame += char(n & 0xff);
+    frame += payload;
+    return writeAll(fd, frame.data(), frame.size());
+}
+
+//------------------------------------------------------------------------------
+// Server
+//------------------------------------------------------------------------------
+namespace {
+
+// Written by the SIGINT/SIGTERM handler to wake the accept loop
+int stopPipe[2] = {-1, -1};
+
+extern "C" void onStopSignal(int) {
+    char c = 0;
+    ssize_t n = ::write(stopPipe[1], &c, 1);
+    (void)n;
+}
+
+} // namespace
+
+// A client connection: closed when the reader and every reply owed are done
+struct DaemonServer::Connection {
+    explicit Connection(int f) : fd(f) {}
+    ~Connection() { ::close(fd); }
+    const int               fd;
+    std::mutex              mutex;
+    std::condition_variable changed;
+    std::deque<std::string> outbox;          // replies given and not yet written
+    std::size_t             inFlight = 0;    // requests read and not yet written back
+    bool                    reading  = true;
+};
+
+// Writes the connection's replies in the order they are given, so the game
+// threads that give them never wait on a slow client. Returns when the reader
+// is done and every request read has been answered.
+void DaemonServer::writeReplies(Connection& conn) {
+    for (;;) {
+        std::string frame;
+        {
+            std::unique_lock<std::mutex> lock(conn.mutex);
+            conn.changed.wait(lock, [&] { return !conn.outbox.empty() || (!conn.reading && conn.inFlight == 0); });
+            if (conn.outbox.empty()) return;
+            frame = std::move(conn.outbox.front());
+            conn.outbox.pop_front();
+        }
+        writeFrame(conn.fd, frame);   // fails once the client is gone: dropped
+        std::lock_guard<std::mutex> lock(conn.mutex);
+        --conn.inFlight;
+        conn.changed.notify_all();
+    }
+}
+
+void DaemonServer::serve(const std::shared_ptr<Connection>& conn) {
+    std::thread writer([conn] { writeReplies(*conn); });
+    std::string payload;
+    for (;;) {
+        // a client pipelining faster than its games finish waits in the
+        // socket buffer, not in the pool's queue
+        {
+            std::unique_lock<std::mutex> lock(conn->mutex);
+            conn->changed.wait(lock, [&] { return conn->inFlight < kMaxInFlight; });
+        }
+        if (!readFrame(conn->fd, payload)) break;
+        ++requests_;
+        MatchRequest req;
+        std::string error;
+        {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            ++conn->inFlight;
+        }
+        Reply reply = [conn](const MatchReply& r) {
+            std::string frame = encodeReply(r);
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            conn->outbox.push_back(std::move(frame));
+            conn->changed.notify_all();
+        };
+        if (parseRequest(payload, req, error)) {
+            handler_(req, std::move(reply));
+        } else {
+            MatchReply r;
+            r.id = req.id;
+            r.error = "bad request: " + error;
+            reply(r);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        conn->reading = false;
+        conn->changed.notify_all();
+    }
+    writer.join();
+}
+
+DaemonServer::DaemonServer(std::string socketPath, Handler handler)
+  : socketPath_(std::move(socketPath)), handler_(std::move(handler))
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(addr.sun_path))
+        throw std::runtime_error("socket path too long: " + socketPath_);
+    std::strcpy(addr.sun_path, socketPath_.c_str());
+
+    // a socket file left by a daemon that died; anything else is not ours
+    struct stat st;
+    if (::lstat(socketPath_.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode))
+            throw std::runtime_error("'" + socketPath_ + "' exists and is not a socket");
+        ::unlink(socketPath_.c_str());
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0)
+        throw std::runtime_error(std::string("socket() failed: ") + std::strerror(errno));
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd_, 64) != 0) {
+        std::string why = std::strerror(errno);
+        ::close(listenFd_);
+        throw std::runtime_error("cannot listen on '" + socketPath_ + "': " + why);
+    }
+}
+
+DaemonServer::~DaemonServer() {
+    ::close(listenFd_);
+    ::unlink(socketPath_.c_str());
+}
+
+void DaemonServer::run() {
+    if (::pipe(stopPipe) != 0)
+        throw std::runtime_error(std::string("pipe() failed: ") + std::strerror(errno));
+    std::signal(SIGPIPE, SIG_IGN);   // a client gone before its reply: write() fails instead
+    std::signal(SIGINT,  onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    // readers are detached; `active` counts those still running
+    std::vector<std::weak_ptr<Connection>> conns;
+    std::mutex              connsMutex;
+    std::condition_variable readersDone;
+    std::size_t             active = 0;
+
+    for (;;) {
+        pollfd fds[2] = {{listenFd_, POLLIN, 0}, {stopPipe[0], POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd < 0) continue;
+
+        auto conn = std::make_shared<Connection>(fd);
+        {
+            std::lock_guard<std::mutex> lock(connsMutex);
+            conns.erase(std::remove_if(conns.begin(), conns.end(),
+                                       [](auto& w) { return w.expired(); }),
+                        conns.end());
+            conns.push_back(conn);
+            ++active;
+        }
+        std::thread([&, conn] {
+            serve(conn);
+            std::lock_guard<std::mutex> lock(connsMutex);
+            if (--active == 0) readersDone.notify_all();
+        }).detach();
+    }
+
+    // stop reading; the readers return once the replies owed have gone out
+    {
+        std::unique_lock<std::mutex> lock(connsMutex);
+        for (auto& w : conns)
+            if (auto c = w.lock()) ::shutdown(c->fd, SHUT_RD);
+        readersDone.wait(lock, [&] { return active == 0; });
+    }
+
+    std::signal(SIGINT,  SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    ::close(stopPipe[0]);
+    ::close(stopPipe[1]);
+}
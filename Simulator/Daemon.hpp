@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Wire format of the simulator daemon (--serve=): every message is a frame of
+// a 4-byte big-endian payload length followed by the payload, which is lines
+// of key=value. A client may send any number of requests on one connection
+// without waiting; each gets exactly one reply, sent when its game is over,
+// so replies come in completion order and carry the request's id.
+//
+//   request:  id=<any>  map=<file>  gm=<name>  algorithm1=<name>  algorithm2=<name>
+//             [max_steps=<N>] [num_shells=<N>]   (default: the map's own)
+//   reply:    id=<same>  status=ok  winner=<0|1|2>  reason=<n>  rounds=<n>
+//             state=<hex>  cached=<0|1>
+//         or  id=<same>  status=error  error=<message>
+//
+// Plugin names are file names in the daemon's plugin folders, ".so" optional.
+// At most kMaxInFlight requests of one connection are being played or waiting
+// to be written back; the daemon reads the next frame once one of them has
+// been, so a client that keeps sending must read its replies meanwhile.
+constexpr std::size_t kMaxFrameBytes = 1 << 20;
+constexpr std::size_t kMaxInFlight   = 64;
+
+struct MatchRequest {
+    std::string id;
+    std::string map, gm, algorithm1, algorithm2;
+    long        maxSteps  = -1;   // -1: the map's MaxSteps
+    long        numShells = -1;   // -1: the map's NumShells
+};
+
+struct MatchReply {
+    std::string   id;
+    std::string   error;   // empty: the game was played (or found in the cache)
+    int           winner = 0;
+    int           reason = 0;
+    std::size_t   rounds = 0;
+    std::uint64_t stateHash = 0;
+    bool          cached = false;
+};
+
+// Fill `req` from a request payload. On error, returns false with `error` set
+// (and whatever id was read, so the error can still be answered).
+bool parseRequest(const std::string& payload, MatchRequest& req, std::string& error);
+std::string encodeReply(const MatchReply& reply);
+
+// Whole-frame I/O on a blocking socket. readFrame() returns false at end of
+// stream, on error, or for a frame over kMaxFrameBytes.
+bool readFrame(int fd, std::string& payload);
+bool writeFrame(int fd, const std::string& payload);
+
+// Accept loop on a Unix-domain socket. Each connection gets a reader thread
+// that hands requests to `handler` with a callback for the reply, and a writer
+// thread that sends the replies; the handler calls the callback exactly once,
+// later and from any thread if it likes. run() returns after SIGINT/SIGTERM
+// once every connection has been read to its end or shut down and every
+// request read from it has been answered.
+class DaemonServer {
+public:
+    using Reply   = std::function<void(const MatchReply&)>;
+    using Handler = std::function<void(const MatchRequest&, Reply)>;
+
+    // Binds `socketPath`, replacing a stale socket file. Throws std::runtime_error.
+    DaemonServer(std::string socketPath, Handler handler);
+    ~DaemonServer();   // closes and unlinks the socket
+
+    DaemonServer(const DaemonServer&) = delete;
+    DaemonServer& operator=(const DaemonServer&) = delete;
+
+    void run();
+
+    std::size_t requests() const { return requests_; }
+
+private:
+    struct Connection;
+    void serve(const std::shared_ptr<Connection>& conn);
+    static void writeReplies(Connection& conn);
+
+    const std::string socketPath_;
+    const Handler     handler_;
+    int               listenFd_ = -1;
+    std::atomic<std::size_t> requests_{0};
+};
@@ -0,0 +1,24 @@
+#include "Hashing.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+
+std::uint64_t hashFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open for hashing: " + path);
+    }
+    std::uint64_t h = kFnvOffset;
+    char buf[1 << 16];
+    while (in) {
+        in.read(buf, sizeof buf);
+        h = fnv1a(buf, static_cast<std::size_t>(in.gcount()), h);
+    }
+    return h;
+}
+
+std::string toHex(std::uint64_t h) {
+    char hex[17];
+    std::snprintf(hex, sizeof hex, "%016llx", static_cast<unsigned long long>(h));
+    return hex;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// 64-bit FNV-1a, used for map/plugin content hashes and board fingerprints.
+constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr std::uint64_t kFnvPrime  = 1099511628211ull;
+
+inline std::uint64_t fnv1a(const void* data, std::size_t len,
+                           std::uint64_t h = kFnvOffset) {
+    auto p = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+// Hash of a file's full contents. Throws std::runtime_error if unreadable.
+std::uint64_t hashFile(const std::string& path);
+
+// Fixed-width lowercase hex, so hashes compare and sort as strings.
+std::string toHex(std::uint64_t h);
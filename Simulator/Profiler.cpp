@@ -0,0 +1,230 @@
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <pthread.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/time.h>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kMaxDepth = 64;
+constexpr std::size_t kSlots    = 4096;   // about 2 MiB; drained every 20 ms
+constexpr int kMainThread  = -1;
+constexpr int kOtherThread = -2;
+// backtrace() from the handler starts with the handler and the signal
+// trampoline; the interrupted code comes after them
+constexpr int kHandlerFrames = 2;
+
+} // namespace
+
+struct SamplingProfiler::Slot {
+    std::atomic<std::uint64_t> seq{0};   // n + 1 once sample n is in this slot
+    int   thread = kOtherThread;         // pool worker index, or kMainThread / kOtherThread
+    int   depth  = 0;
+    void* pcs[kMaxDepth + kHandlerFrames];
+};
+
+namespace {
+
+// shared with the signal handler: plain atomics and pointers only
+std::atomic<bool>          gRunning{false};
+SamplingProfiler::Slot*    gSlots = nullptr;   // set while gRunning
+std::atomic<std::uint64_t> gWritten{0};        // samples claimed
+std::atomic<std::uint64_t> gDrained{0};        // samples handed to the drainer
+std::atomic<std::uint64_t> gDropped{0};        // ring full
+pthread_t                  gMainThread;
+
+extern "C" void onProfSignal(int, siginfo_t*, void*) {
+    const int savedErrno = errno;
+    std::uint64_t n = gWritten.load(std::memory_order_relaxed);
+    do {
+        if (n - gDrained.load(std::memory_order_acquire) >= kSlots) {
+            gDropped.fetch_add(1, std::memory_order_relaxed);
+            errno = savedErrno;
+            return;
+        }
+    } while (!gWritten.compare_exchange_weak(n, n + 1, std::memory_order_relaxed));
+
+    SamplingProfiler::Slot& slot = gSlots[n % kSlots];
+    const int worker = ThreadPool::currentWorker();
+    slot.thread = worker >= 0 ? worker
+                : pthread_equal(pthread_self(), gMainThread) ? kMainThread : kOtherThread;
+    slot.depth  = backtrace(slot.pcs, int(kMaxDepth + kHandlerFrames));
+    slot.seq.store(n + 1, std::memory_order_release);
+    errno = savedErrno;
+}
+
+std::string baseName(const char* path) {
+    if (!path || !*path) return "[unknown]";
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+} // namespace
+
+SamplingProfiler::SamplingProfiler(std::string outputPath, int hz)
+  : outputPath_(std::move(outputPath)), hz_(hz), slots_(new Slot[kSlots])
+{
+    // find out now, not after the run, that the profile cannot be written
+    if (!std::ofstream(outputPath_, std::ios::trunc))
+        throw std::runtime_error("cannot write profile '" + outputPath_ + "'");
+    if (gRunning.exchange(true))
+        throw std::runtime_error("a profiler is already running");
+
+    // the first backtrace() loads the unwinder, which must not happen in the handler
+    void* warm[4];
+    backtrace(warm, 4);
+
+    gSlots      = slots_.get();
+    gWritten    = 0;
+    gDrained    = 0;
+    gDropped    = 0;
+    gMainThread = pthread_self();
+
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = onProfSignal;
+    sa.sa_flags     = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, nullptr) != 0) {
+        gRunning = false;
+        throw std::runtime_error(std::string("cannot install the SIGPROF handler: ") + std::strerror(errno));
+    }
+    drainer_ = std::thread([this] { drainLoop(); });
+
+    itimerval timer;
+    timer.it_interval.tv_sec  = 0;
+    timer.it_interval.tv_usec = 1000000 / hz_;
+    timer.it_value            = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        std::string why = std::strerror(errno);
+        stopping_ = true;
+        drainer_.join();
+        std::signal(SIGPROF, SIG_DFL);
+        gRunning = false;
+        throw std::runtime_error("cannot start the profiling timer: " + why);
+    }
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    if (stopped_) return;
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    stopping_ = true;
+    drainer_.join();
+    std::signal(SIGPROF, SIG_IGN);   // a signal may still be pending
+    gRunning = false;
+}
+
+void SamplingProfiler::drainLoop() {
+    while (!stopping_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        drain();
+    }
+    drain();
+}
+
+void SamplingProfiler::drain() {
+    for (std::uint64_t n = gDrained.load(std::memory_order_relaxed);
+         n < gWritten.load(std::memory_order_acquire); ++n) {
+        Slot& slot = slots_[n % kSlots];
+        if (slot.seq.load(std::memory_order_acquire) != n + 1) break;   // still being written
+
+        std::string stack = slot.thread == kMainThread  ? "main"
+                          : slot.thread == kOtherThread ? "other-thread"
+                          : "worker-" + std::to_string(slot.thread);
+        // backtrace() lists the leaf first; folded stacks start at the root
+        for (int f = slot.depth - 1; f >= kHandlerFrames; --f) {
+            // return addresses point after the call; step back into it
+            void* pc = f == kHandlerFrames ? slot.pcs[f]
+                                           : static_cast<char*>(slot.pcs[f]) - 1;
+            stack += ';';
+            stack += resolve(pc).name;
+        }
+        if (slot.depth > kHandlerFrames) {
+            ++selfByObject_[resolve(slot.pcs[kHandlerFrames]).object];
+            ++folded_[stack];
+            ++samples_;
+        }
+        gDrained.store(n + 1, std::memory_order_release);
+    }
+}
+
+const SamplingProfiler::Frame& SamplingProfiler::resolve(void* pc) {
+    auto it = frames_.find(pc);
+    if (it != frames_.end()) return it->second;
+
+    Frame frame;
+    Dl_info info;
+    if (dladdr(pc, &info) == 0) {
+        frame.object = "[unknown]";
+        std::ostringstream os;
+        os << "[unknown]`" << pc;
+        frame.name = os.str();
+    } else {
+        frame.object = baseName(info.dli_fname);
+        std::string function;
+        if (info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            function = status == 0 && demangled ? demangled : info.dli_sname;
+            std::free(demangled);
+        } else {
+            // no exported symbol (static or hidden): the offset in the object
+            std::ostringstream os;
+            os << "0x" << std::hex << (static_cast<char*>(pc) - static_cast<char*>(info.dli_fbase));
+            function = os.str();
+        }
+        frame.name = frame.object + "`" + function;
+    }
+    return frames_.emplace(pc, std::move(frame)).first->second;
+}
+
+void SamplingProfiler::stop(std::ostream& summary) {
+    if (stopped_) return;
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    stopping_ = true;
+    drainer_.join();
+    std::signal(SIGPROF, SIG_IGN);
+    gRunning = false;
+    stopped_ = true;
+
+    std::ofstream out(outputPath_, std::ios::trunc);
+    if (!out)
+        throw std::runtime_error("cannot write profile '" + outputPath_ + "'");
+    for (auto& [stack, count] : folded_)
+        out << stack << ' ' << count << '\n';
+    out.flush();
+    if (!out)
+        throw std::runtime_error("cannot write profile '" + outputPath_ + "'");
+
+    const auto flags = summary.flags();
+    const auto prec  = summary.precision();
+    summary << "[Profiler] " << samples_ << " samples at " << hz_ << " Hz";
+    if (std::uint64_t dropped = gDropped.load()) summary << " (" << dropped << " dropped)";
+    summary << " -> " << outputPath_ << "\n";
+    std::vector<std::pair<std::uint64_t, std::string>> byShare;
+    for (auto& [object, count] : selfByObject_) byShare.emplace_back(count, object);
+    std::sort(byShare.rbegin(), byShare.rend());
+    summary << std::fixed << std::setprecision(1);
+    for (auto& [count, object] : byShare)
+        summary << "  " << std::setw(5) << (100.0 * double(count) / double(samples_)) << "%  "
+                << object << "\n";
+    summary.flags(flags);
+    summary.precision(prec);
+}
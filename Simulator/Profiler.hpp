@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Sampling CPU profiler (profile=<file>). An ITIMER_PROF timer sends SIGPROF
+// `hz` times per second of CPU used by the process. The handler, on whichever
+// thread was running, copies that thread's stack into a preallocated ring of
+// slots. A drain thread empties the ring: it names each frame with dladdr()
+// as "<object>`<function>", so plugin code is credited to its .so, and folds
+// identical stacks together. Each stack starts at the thread's name: pool
+// worker, main thread or other thread. stop() writes one
+// "root;...;leaf <count>" line per stack, the folded format flamegraph.pl
+// and speedscope read. Only one profiler may run at a time.
+class SamplingProfiler {
+public:
+    // Starts sampling. Throws std::runtime_error if `outputPath` cannot be
+    // written, if the timer or the signal handler cannot be installed, or if
+    // another profiler is running.
+    SamplingProfiler(std::string outputPath, int hz);
+    ~SamplingProfiler();   // stops without writing, if stop() was not called
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    // Stops sampling, writes the folded stacks, and prints the share of
+    // samples executing in each object (.so or the simulator) to `summary`.
+    // Throws std::runtime_error if the file cannot be written.
+    void stop(std::ostream& summary);
+
+    struct Slot;   // one sample in the ring, written by the signal handler
+
+private:
+
+    void drainLoop();
+    void drain();
+    struct Frame { std::string name, object; };
+    const Frame& resolve(void* pc);
+
+    const std::string outputPath_;
+    const int         hz_;
+    std::unique_ptr<Slot[]> slots_;
+
+    std::atomic<bool> stopping_{false};
+    bool              stopped_ = false;
+    std::thread       drainer_;
+
+    // drain-thread state, read by stop() after the drainer is joined
+    std::unordered_map<void*, Frame> frames_;
+    std::map<std::string, std::uint64_t> folded_;
+    std::map<std::string, std::uint64_t> selfByObject_;
+    std::uint64_t samples_ = 0;
+};
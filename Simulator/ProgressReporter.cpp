@@ -0,0 +1,137 @@
+#include "ProgressReporter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+ProgressReporter::ProgressReporter(ThreadPool& pool, std::size_t totalGames,
+                                   std::chrono::milliseconds interval,
+                                   bool toStderr, std::string metricsPath)
+  : pool_(pool),
+    total_(totalGames),
+    interval_(interval),
+    toStderr_(toStderr),
+    metricsPath_(std::move(metricsPath)),
+    start_(Clock::now()),
+    lastReport_(start_),
+    thread_([this] { loop(); })
+{}
+
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+void ProgressReporter::gamePlayed(std::size_t rounds) {
+    turns_ += rounds;
+    ++played_;
+}
+
+void ProgressReporter::gamesResumed(std::size_t n) { resumed_ += n; }
+void ProgressReporter::gamesFailed(std::size_t n)  { failed_  += n; }
+void ProgressReporter::gamesSkipped(std::size_t n) { skipped_ += n; }
+
+void ProgressReporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;
+        stopping_ = true;
+    }
+    cond_.notify_all();
+    thread_.join();
+    report(true);
+}
+
+void ProgressReporter::loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cond_.wait_for(lock, interval_, [this] { return stopping_; })) {
+        lock.unlock();
+        report(false);
+        lock.lock();
+    }
+}
+
+void ProgressReporter::report(bool final) {
+    const auto now = Clock::now();
+    const double elapsed = std::chrono::duration<double>(now - start_).count();
+    const double window  = std::chrono::duration<double>(now - lastReport_).count();
+    const ThreadPool::Stats st = pool_.stats();
+
+    const std::uint64_t played = played_, resumed = resumed_, failed = failed_, turns = turns_;
+    const std::uint64_t skipped = skipped_;
+    const std::uint64_t done = played + resumed + failed + skipped;
+    const double gamesPerSec = elapsed > 0 ? played / elapsed : 0;
+    const double turnsPerSec = elapsed > 0 ? turns / elapsed : 0;
+    const double eta = (gamesPerSec > 0 && total_ > done) ? (total_ - done) / gamesPerSec : 0;
+
+    std::vector<double> util(st.busySeconds.size(), 0.0);
+    lastBusy_.resize(st.busySeconds.size(), 0.0);
+    for (std::size_t w = 0; w < util.size(); ++w) {
+        if (window > 0) util[w] = std::min(1.0, (st.busySeconds[w] - lastBusy_[w]) / window);
+        lastBusy_[w] = st.busySeconds[w];
+    }
+    lastReport_ = now;
+
+    if (toStderr_) {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(1)
+           << "[Progress] " << done << "/" << total_ << " games";
+        if (resumed || failed || skipped) {
+            os << " (" << resumed << " resumed, " << failed << " failed";
+            if (skipped) os << ", " << skipped << " skipped";
+            os << ")";
+        }
+        os << " | " << gamesPerSec << " games/s, " << turnsPerSec << " turns/s"
+           << " | queue " << st.queued << " (+" << st.waiting << " waiting)"
+           << " | util";
+        for (double u : util) os << ' ' << int(u * 100 + 0.5) << '%';
+        if (final)                 os << " | done in " << elapsed << "s";
+        else if (gamesPerSec > 0)  os << " | ETA " << eta << "s";
+        os << '\n';
+        std::cerr << os.str();
+    }
+
+    if (metricsPath_.empty()) return;
+    std::ostringstream m;
+    auto metric = [&](const char* name, const char* type, const char* help, double value) {
+        m << "# HELP " << name << ' ' << help << '\n'
+          << "# TYPE " << name << ' ' << type << '\n'
+          << name << ' ' << value << '\n';
+    };
+    m << std::setprecision(12);
+    metric("sim_games_total",            "gauge",   "Games in this run (this shard).", double(total_));
+    metric("sim_games_played_total",     "counter", "Games played to the end.", double(played));
+    metric("sim_games_resumed_total",    "counter", "Games taken from the journal or the result cache.", double(resumed));
+    metric("sim_games_failed_total",     "counter", "Games lost to a bad map or a failed batch.", double(failed));
+    metric("sim_games_skipped_total",    "counter", "Games of decided pairs not played (early_stop=).", double(skipped));
+    metric("sim_turns_total",            "counter", "Turns of the games played.", double(turns));
+    metric("sim_games_per_second",       "gauge",   "Games played per second since start.", gamesPerSec);
+    metric("sim_turns_per_second",       "gauge",   "Turns played per second since start.", turnsPerSec);
+    metric("sim_eta_seconds",            "gauge",   "Estimated seconds to finish (0 if unknown).", eta);
+    metric("sim_elapsed_seconds",        "gauge",   "Seconds since the games started.", elapsed);
+    metric("sim_pool_queued_tasks",      "gauge",   "Pool tasks ready to run.", double(st.queued));
+    metric("sim_pool_waiting_tasks",     "gauge",   "Pool tasks waiting on dependencies.", double(st.waiting));
+    metric("sim_finished",               "gauge",   "1 once the run is over.", final ? 1.0 : 0.0);
+    m << "# HELP sim_worker_busy_seconds_total Time each pool worker spent running tasks.\n"
+      << "# TYPE sim_worker_busy_seconds_total counter\n";
+    for (std::size_t w = 0; w < util.size(); ++w)
+        m << "sim_worker_busy_seconds_total{worker=\"" << w << "\"} " << st.busySeconds[w] << '\n';
+    m << "# HELP sim_worker_utilization Busy fraction of each pool worker since the previous report.\n"
+      << "# TYPE sim_worker_utilization gauge\n";
+    for (std::size_t w = 0; w < util.size(); ++w)
+        m << "sim_worker_utilization{worker=\"" << w << "\"} " << util[w] << '\n';
+
+    const std::string tmp = metricsPath_ + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << m.str();
+        if (!out) {
+            std::cerr << "Warning: cannot write metrics file '" << tmp << "'\n";
+            return;
+        }
+    }
+    if (std::rename(tmp.c_str(), metricsPath_.c_str()) != 0)
+        std::cerr << "Warning: cannot replace metrics file '" << metricsPath_ << "'\n";
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Live progress of a competition: a background thread that, every `interval`,
+// prints one status line to stderr (when `toStderr`) and rewrites
+// `metricsPath` (when non-empty) in Prometheus text exposition format. The
+// file is replaced by rename(), so a scraper never reads half of it. Counting
+// calls are thread-safe; a last report is written on stop().
+class ProgressReporter {
+public:
+    ProgressReporter(ThreadPool& pool, std::size_t totalGames,
+                     std::chrono::milliseconds interval,
+                     bool toStderr, std::string metricsPath);
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    void gamePlayed(std::size_t rounds);
+    void gamesResumed(std::size_t n);   // taken from the journal or result cache, not played
+    void gamesFailed(std::size_t n);    // map or batch failed; never played
+    void gamesSkipped(std::size_t n);   // cancelled by early_stop=; never played
+
+    void stop();
+
+private:
+    void loop();
+    void report(bool final);
+
+    using Clock = std::chrono::steady_clock;
+
+    ThreadPool&               pool_;
+    const std::size_t         total_;
+    const std::chrono::milliseconds interval_;
+    const bool                toStderr_;
+    const std::string         metricsPath_;
+    const Clock::time_point   start_;
+
+    std::atomic<std::uint64_t> played_{0}, resumed_{0}, failed_{0}, skipped_{0}, turns_{0};
+
+    // utilization is busy time over wall time since the previous report
+    Clock::time_point   lastReport_;
+    std::vector<double> lastBusy_;
+
+    std::mutex              mutex_;
+    std::condition_variable cond_;
+    bool                    stopping_ = false;
+    std::thread             thread_;
+};
@@ -0,0 +1,181 @@
+#include "Ratings.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+
+namespace {
+
+constexpr double kAnchorElo = 1500;
+constexpr double kEloPerNat = 400 / 2.302585092994046;   // 400 / ln 10
+constexpr double kZ95       = 1.959963984540054;
+
+} // namespace
+
+std::vector<Rating> rateGames(std::size_t players, const std::vector<RatedGame>& games) {
+    std::vector<Rating> out(players);
+    if (players == 0) return out;
+
+    // score and games per pair; the virtual anchor is player `players`
+    const std::size_t n = players + 1;
+    std::vector<double> score(n, 0.0), count(n * n, 0.0);
+    for (const RatedGame& g : games) {
+        if (g.a == g.b || g.a >= players || g.b >= players) continue;
+        score[g.a] += g.scoreA;
+        score[g.b] += 1 - g.scoreA;
+        count[g.a * n + g.b] += 1;
+        count[g.b * n + g.a] += 1;
+        if      (g.scoreA > 0.5) { ++out[g.a].wins;   ++out[g.b].losses; }
+        else if (g.scoreA < 0.5) { ++out[g.a].losses; ++out[g.b].wins;   }
+        else                     { ++out[g.a].draws;  ++out[g.b].draws;  }
+    }
+    for (std::size_t i = 0; i < players; ++i) {
+        score[i] += 0.5;
+        count[i * n + players] += 1;
+        count[players * n + i] += 1;
+    }
+
+    // minorization-maximization (Hunter 2004): gamma_i = W_i / sum_j n_ij / (gamma_i + gamma_j),
+    // the anchor held at 1; every step raises the likelihood
+    std::vector<double> gamma(n, 1.0), next(n, 1.0);
+    for (int iter = 0; iter < 10000; ++iter) {
+        double change = 0;
+        for (std::size_t i = 0; i < players; ++i) {
+            double denom = 0;
+            for (std::size_t j = 0; j < n; ++j)
+                if (count[i * n + j] > 0) denom += count[i * n + j] / (gamma[i] + gamma[j]);
+            next[i] = score[i] / denom;
+            change = std::max(change, std::fabs(std::log(next[i] / gamma[i])));
+        }
+        std::copy(next.begin(), next.begin() + std::ptrdiff_t(players), gamma.begin());
+        if (change < 1e-10) break;
+    }
+
+    // Fisher information of log gamma_i, other ratings held fixed
+    for (std::size_t i = 0; i < players; ++i) {
+        double info = 0;
+        for (std::size_t j = 0; j < n; ++j) {
+            if (count[i * n + j] == 0) continue;
+            double p = gamma[i] / (gamma[i] + gamma[j]);
+            info += count[i * n + j] * p * (1 - p);
+        }
+        out[i].elo  = kAnchorElo + kEloPerNat * std::log(gamma[i]);
+        out[i].ci95 = kZ95 * kEloPerNat / std::sqrt(info);
+    }
+    return out;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>>
+swissPairs(const std::vector<double>& rating,
+           const std::vector<std::vector<unsigned>>& met,
+           std::vector<unsigned>& byes) {
+    const std::size_t n = rating.size();
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return rating[a] > rating[b];
+    });
+
+    std::vector<char> taken(n, 0);
+    if (n % 2 == 1) {
+        std::size_t bye = order.back();
+        for (std::size_t k = n; k-- > 0; )
+            if (byes[order[k]] < byes[bye]) bye = order[k];
+        taken[bye] = 1;
+        ++byes[bye];
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t a = order[k];
+        if (taken[a]) continue;
+        taken[a] = 1;
+        std::size_t best = n;
+        for (std::size_t m = k + 1; m < n; ++m) {
+            const std::size_t b = order[m];
+            if (taken[b]) continue;
+            if (best == n || met[a][b] < met[a][best]) best = b;
+            if (met[a][b] == 0) break;   // nearest new opponent
+        }
+        if (best == n) break;
+        taken[best] = 1;
+        pairs.emplace_back(std::min(a, best), std::max(a, best));
+    }
+    return pairs;
+}
+
+std::size_t defaultSwissRounds(std::size_t players) {
+    std::size_t log2 = 0;
+    while ((std::size_t(1) << log2) < players) ++log2;
+    return std::max<std::size_t>(1, 2 * log2);
+}
+
+void printRatings(std::ostream& out, const std::vector<std::string>& names,
+                  const std::vector<Rating>& ratings, const std::string& headerNote) {
+    std::vector<std::size_t> order(ratings.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        if (ratings[a].elo != ratings[b].elo) return ratings[a].elo > ratings[b].elo;
+        return names[a] < names[b];
+    });
+
+    out << "[Simulator] Ratings:";
+    if (!headerNote.empty()) out << " " << headerNote;
+    out << "\n";
+    const auto flags = out.flags();
+    const auto prec  = out.precision();
+    out << std::fixed << std::setprecision(1);
+    for (std::size_t rank = 0; rank < order.size(); ++rank) {
+        const Rating& r = ratings[order[rank]];
+        out << "  " << (rank + 1) << ". " << names[order[rank]]
+            << "  elo=" << r.elo << " +/-" << r.ci95
+            << "  W/L/D=" << r.wins << "/" << r.losses << "/" << r.draws << "\n";
+    }
+    out.flags(flags);
+    out.precision(prec);
+}
+
+PairVerdict sequentialTest(std::size_t wins, std::size_t losses, std::size_t draws,
+                           double confidence, double* reached) {
+    const double winStep  = std::log(kSprtFavourite / 0.5);
+    const double lossStep = std::log((1 - kSprtFavourite) / 0.5);
+    const double bound    = std::log(confidence / (1 - confidence));
+    const double scored   = double(wins) + 0.5 * double(draws);    // the first side's
+    const double conceded = double(losses) + 0.5 * double(draws);
+    const double first    = scored * winStep + conceded * lossStep;
+    const double second   = conceded * winStep + scored * lossStep;
+    auto posterior = [](double llr) { return 1 / (1 + std::exp(-llr)); };
+
+    PairVerdict verdict = PairVerdict::Open;
+    double llr = 0;
+    if      (first  >= bound)                     { verdict = PairVerdict::FirstStronger;  llr = first; }
+    else if (second >= bound)                     { verdict = PairVerdict::SecondStronger; llr = second; }
+    else if (first <= -bound && second <= -bound) { verdict = PairVerdict::Even; llr = -std::max(first, second); }
+    else                                          llr = std::max({first, second, -std::max(first, second)});
+    if (reached) *reached = posterior(llr);
+    return verdict;
+}
+
+void printPairVerdicts(std::ostream& out, const std::vector<PairRecord>& pairs, double confidence) {
+    const auto flags = out.flags();
+    const auto prec  = out.precision();
+    out << "[Simulator] Early stop: (confidence " << confidence << ")\n";
+    out << std::fixed << std::setprecision(3);
+    for (const PairRecord& p : pairs) {
+        out << "  " << p.a1 << " vs " << p.a2 << ": ";
+        switch (p.verdict) {
+        case PairVerdict::FirstStronger:  out << p.a1 << " stronger"; break;
+        case PairVerdict::SecondStronger: out << p.a2 << " stronger"; break;
+        case PairVerdict::Even:           out << "even"; break;
+        case PairVerdict::Open:           out << "undecided"; break;
+        }
+        out << " (confidence " << p.confidence << ") after "
+            << (p.wins + p.losses + p.draws) << " games";
+        if (p.skipped > 0) out << ", " << p.skipped << " skipped";
+        out << "  W/L/D=" << p.wins << "/" << p.losses << "/" << p.draws << "\n";
+    }
+    out.flags(flags);
+    out.precision(prec);
+}
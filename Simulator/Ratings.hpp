@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One finished game between players a and b (indices into the player list)
+// from a's side: 1 win, 0.5 draw, 0 loss.
+struct RatedGame {
+    std::size_t a, b;
+    double      scoreA;
+};
+
+struct Rating {
+    double      elo  = 1500;   // on the Elo scale, a virtual 1500 opponent as anchor
+    double      ci95 = 0;      // half-width of the 95% confidence interval
+    std::size_t wins = 0, losses = 0, draws = 0;
+};
+
+// Bradley-Terry maximum-likelihood ratings of `players` from `games`, draws
+// counting half to each side, on the Elo scale. Every player also gets one
+// virtual draw against a fixed 1500 player, so ratings stay finite for a
+// player who never lost (or never won) and everyone is on one scale. The
+// interval comes from the likelihood's curvature at the optimum. The result
+// depends only on the set of games, not their order.
+std::vector<Rating> rateGames(std::size_t players, const std::vector<RatedGame>& games);
+
+// The pairs of one Swiss round. Players are taken best rating first (ties by
+// index); each is paired with the next lower-rated free player it has met
+// least often, so rematches only happen once nobody else is left. With an odd
+// count, the lowest-rated player with the fewest byes sits the round out, and
+// its bye is counted in `byes`. `met[a][b]` counts earlier meetings. Each
+// pair is returned as (lower index, higher index).
+std::vector<std::pair<std::size_t, std::size_t>>
+swissPairs(const std::vector<double>& rating,
+           const std::vector<std::vector<unsigned>>& met,
+           std::vector<unsigned>& byes);
+
+// Rounds for `players` when swiss_rounds= is not given: 2·ceil(log2 n), so a
+// competition is O(n log n) games.
+std::size_t defaultSwissRounds(std::size_t players);
+
+// Ranking table: best rating first, ties by name.
+void printRatings(std::ostream& out, const std::vector<std::string>& names,
+                  const std::vector<Rating>& ratings, const std::string& headerNote = "");
+
+enum class PairVerdict { Open, FirstStronger, SecondStronger, Even };
+
+// Wald's sequential probability ratio test on one pair's game scores (a draw
+// is half a win). Two tests run side by side, "the first side scores
+// kSprtFavourite per game" against "the sides are even" and the same for the
+// second side, each with error rates 1 - confidence. A side is stronger once
+// its test accepts the favourite; the pair is even once both accept "even".
+// `reached`, when given, is set to the posterior probability of the verdict
+// (or, while open, of the likeliest outcome) with even priors. `confidence`
+// is in (0.5, 1).
+constexpr double kSprtFavourite = 0.7;
+PairVerdict sequentialTest(std::size_t wins, std::size_t losses, std::size_t draws,
+                           double confidence, double* reached = nullptr);
+
+// One algorithm pair of an early-stopped competition (early_stop=).
+struct PairRecord {
+    std::string a1, a2;
+    std::size_t wins = 0, losses = 0, draws = 0;   // from a1's side
+    std::size_t skipped = 0;                        // queued games cancelled by the verdict
+    PairVerdict verdict = PairVerdict::Open;
+    double      confidence = 0;
+};
+
+// The verdict of every pair, in the order given.
+void printPairVerdicts(std::ostream& out, const std::vector<PairRecord>& pairs, double confidence);
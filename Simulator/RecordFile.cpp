@@ -0,0 +1,87 @@
+#include "RecordFile.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+RecordFile::RecordFile(const std::string& path, const std::string& what, std::size_t syncEvery)
+  : fd_(::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)),
+    what_(what), syncEvery_(syncEvery)
+{
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open " + what_ + " '" + path + "': " + std::strerror(errno));
+    }
+    // a crash can leave a torn last line; terminate it so our first record
+    // starts on a fresh line
+    int rfd = ::open(path.c_str(), O_RDONLY);
+    if (rfd >= 0) {
+        char last = '\n';
+        off_t end = ::lseek(rfd, 0, SEEK_END);
+        if (end > 0 && ::pread(rfd, &last, 1, end - 1) == 1 && last != '\n') {
+            ssize_t n = ::write(fd_, "\n", 1);
+            (void)n;
+        }
+        ::close(rfd);
+    }
+}
+
+RecordFile::~RecordFile() {
+    flush();
+    ::close(fd_);
+}
+
+void RecordFile::append(const std::vector<std::string>& fields) {
+    std::string line;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        if (i) line += '\t';
+        line += fields[i];
+    }
+    line += '\n';
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t off = 0;
+    while (off < line.size()) {
+        ssize_t n = ::write(fd_, line.data() + off, line.size() - off);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write " + what_ + ": " + std::strerror(errno));
+        }
+        off += size_t(n);
+    }
+    if (++unsynced_ == syncEvery_) {
+        ::fsync(fd_);
+        unsynced_ = 0;
+    }
+}
+
+void RecordFile::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (unsynced_ > 0) {
+        ::fsync(fd_);
+        unsynced_ = 0;
+    }
+}
+
+void RecordFile::read(const std::string& path,
+                      const std::function<void(const std::vector<std::string>&)>& f) {
+    std::ifstream in(path);
+    if (!in.is_open()) return;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (in.eof()) break;   // no trailing '\n': torn write, drop it
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t')) fields.push_back(field);
+        try {
+            f(fields);
+        } catch (const std::exception&) {
+            // malformed record: skip it
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Append-only file of newline-terminated, tab-separated records: the storage
+// under ResultJournal and ResultCache.
+//
+// append() is thread-safe. Records are written under a lock and a short
+// write() is resumed where it stopped, so the records of one writer never
+// interleave; the file is meant to have one writer at a time. A crash can
+// still leave a torn last record. Opening terminates it, so the next record
+// starts on a fresh line, and read() skips it either way.
+class RecordFile {
+public:
+    // `what` names the file in error messages. Every `syncEvery` records are
+    // fsynced (0: only on flush() and close). Throws std::runtime_error if
+    // the file cannot be opened.
+    RecordFile(const std::string& path, const std::string& what, std::size_t syncEvery = 0);
+    ~RecordFile();
+
+    RecordFile(const RecordFile&) = delete;
+    RecordFile& operator=(const RecordFile&) = delete;
+
+    void append(const std::vector<std::string>& fields);
+    void flush();
+
+    // Calls `f` with the fields of every complete record in `path`, in file
+    // order. A missing file has none; a record `f` throws on is skipped.
+    // Read a file before opening it: opening terminates a torn last record,
+    // which would then read as complete.
+    static void read(const std::string& path,
+                     const std::function<void(const std::vector<std::string>&)>& f);
+
+private:
+    int         fd_;
+    std::string what_;
+    std::size_t syncEvery_;
+    std::size_t unsynced_ = 0;
+    std::mutex  mutex_;
+};
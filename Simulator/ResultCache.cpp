@@ -0,0 +1,52 @@
+#include "ResultCache.hpp"
+#include "Hashing.hpp"
+
+#include <vector>
+
+std::string CacheKey::str() const {
+    return toHex(gm) + '\t' + toHex(a1) + '\t' + toHex(a2) + '\t' + toHex(map) + '\t' + params;
+}
+
+// <gm> <a1> <a2> <map> <params> <winner> <reason> <rounds> <state>, tab-separated;
+// a malformed line is skipped, the game will simply be played
+static std::unordered_map<std::string, CachedResult> loadEntries(const std::string& path) {
+    std::unordered_map<std::string, CachedResult> entries;
+    RecordFile::read(path, [&](const std::vector<std::string>& f) {
+        if (f.size() != 9 || f[8].size() != 16) return;
+        CachedResult r;
+        r.winner    = std::stoi(f[5]);
+        r.reason    = std::stoi(f[6]);
+        r.rounds    = std::stoul(f[7]);
+        r.stateHash = std::stoull(f[8], nullptr, 16);
+        entries[f[0] + '\t' + f[1] + '\t' + f[2] + '\t' + f[3] + '\t' + f[4]] = r;
+    });
+    return entries;
+}
+
+ResultCache::ResultCache(const std::string& path)
+  : entries_(loadEntries(path)), file_(path, "result cache")
+{}
+
+bool ResultCache::find(const CacheKey& key, CachedResult& out) const {
+    if (!key.valid()) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key.str());
+    if (it == entries_.end()) return false;
+    out = it->second;
+    return true;
+}
+
+void ResultCache::store(const CacheKey& key, const CachedResult& r) {
+    if (!key.valid()) return;
+    const std::string k = key.str();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[k] = r;
+    }
+    file_.append({ k, std::to_string(r.winner), std::to_string(r.reason),
+                   std::to_string(r.rounds), toHex(r.stateHash) });
+}
+
+void ResultCache::flush() {
+    file_.flush();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+#include "RecordFile.hpp"
+
+// Everything a game's result depends on: the GM and both algorithm binaries,
+// the map file (which carries MaxSteps/NumShells) and the game parameters.
+// Deterministic plugins give the same result for the same key. A zero hash
+// means an input could not be fingerprinted; such games are not cached.
+struct CacheKey {
+    std::uint64_t gm = 0, a1 = 0, a2 = 0, map = 0;
+    std::string   params;
+
+    bool        valid() const { return gm && a1 && a2 && map; }
+    std::string str() const;
+};
+
+struct CachedResult {
+    int           winner = 0;
+    int           reason = 0;
+    std::size_t   rounds = 0;
+    std::uint64_t stateHash = 0;   // final board, as the comparative report hashes it
+};
+
+// Persistent result store shared across runs: one tab-separated line per
+// game, appended as games finish. Opening reads every complete line, later
+// lines winning, so results stored by a forced re-run replace older ones.
+// find() and store() are thread-safe.
+class ResultCache {
+public:
+    explicit ResultCache(const std::string& path);
+
+    bool find(const CacheKey& key, CachedResult& out) const;
+    void store(const CacheKey& key, const CachedResult& r);
+    void flush();
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, CachedResult> entries_;   // read before file_ opens it
+    RecordFile file_;
+};
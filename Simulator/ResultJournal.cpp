@@ -0,0 +1,42 @@
+#include "ResultJournal.hpp"
+#include "Hashing.hpp"
+
+#include <string>
+
+std::string journalKey(std::uint64_t mapHash, const std::string& a1,
+                       const std::string& a2, const std::string& gm) {
+    return toHex(mapHash) + '\t' + a1 + '\t' + a2 + '\t' + gm;
+}
+
+ResultJournal::ResultJournal(const std::string& path, std::size_t batch)
+  : file_(path, "journal", batch == 0 ? 1 : batch)
+{}
+
+void ResultJournal::append(const JournalRecord& r) {
+    // <maphash> <gm> <a1> <a2> <winner> <reason> <rounds> <mapFile>, tab-separated
+    file_.append({ toHex(r.mapHash), r.gm, r.a1, r.a2, std::to_string(r.winner),
+                   std::to_string(r.reason), std::to_string(r.rounds), r.mapFile });
+}
+
+void ResultJournal::flush() {
+    file_.flush();
+}
+
+std::vector<JournalRecord> ResultJournal::load(const std::string& path) {
+    // a malformed line is skipped: the game will simply be replayed
+    std::vector<JournalRecord> out;
+    RecordFile::read(path, [&](const std::vector<std::string>& f) {
+        if (f.size() != 8 || f[0].size() != 16) return;
+        JournalRecord r;
+        r.mapHash = std::stoull(f[0], nullptr, 16);
+        r.gm      = f[1];
+        r.a1      = f[2];
+        r.a2      = f[3];
+        r.winner  = std::stoi(f[4]);
+        r.reason  = std::stoi(f[5]);
+        r.rounds  = std::stoul(f[6]);
+        r.mapFile = f[7];
+        out.push_back(std::move(r));
+    });
+    return out;
+}
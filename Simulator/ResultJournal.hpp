@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "RecordFile.hpp"
+
+// One finished competition game, as recorded in the journal.
+struct JournalRecord {
+    std::uint64_t mapHash = 0;
+    std::string   gm, a1, a2;
+    int           winner = 0;
+    int           reason = 0;
+    std::size_t   rounds = 0;
+    std::string   mapFile;   // informational; the key uses mapHash
+};
+
+// Identity of a game across runs: (map content hash, algorithm pair, GM).
+std::string journalKey(std::uint64_t mapHash, const std::string& a1,
+                       const std::string& a2, const std::string& gm);
+
+// Append-only, line-per-game journal. append() is thread-safe; records are
+// written immediately and fsynced every `batch` records (and on flush/close),
+// so a crash loses at most the unsynced tail, never a torn earlier record.
+class ResultJournal {
+public:
+    explicit ResultJournal(const std::string& path, std::size_t batch = 16);
+
+    void append(const JournalRecord& rec);
+    void flush();
+
+    // Reads every complete record in `path`; a missing file yields none and
+    // a torn trailing line (from a crash mid-write) is ignored.
+    static std::vector<JournalRecord> load(const std::string& path);
+
+private:
+    RecordFile file_;
+};
@@ -0,0 +1,25 @@
+#include "Sharding.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+std::vector<std::size_t> assignShards(const std::vector<double>& costs, std::size_t shardCount) {
+    std::vector<std::size_t> shardOf(costs.size(), 0);
+    if (shardCount <= 1) return shardOf;
+
+    std::vector<std::size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return costs[a] > costs[b];
+    });
+
+    std::vector<double> load(shardCount, 0.0);
+    for (std::size_t t : order) {
+        std::size_t best = 0;
+        for (std::size_t s = 1; s < shardCount; ++s)
+            if (load[s] < load[best]) best = s;
+        shardOf[t] = best;
+        load[best] += costs[t];
+    }
+    return shardOf;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Deterministically splits tasks across `shardCount` shards, balancing the
+// estimated cost (greedy longest-processing-time: heaviest task first onto
+// the least-loaded shard, ties broken by index). Every process that sees the
+// same costs computes the same assignment. Returns the shard of each task.
+std::vector<std::size_t> assignShards(const std::vector<double>& costs, std::size_t shardCount);
@@ -1,26 +1,52 @@
 #include "ThreadPool.hpp"
+#include "CpuTopology.hpp"
 #include <iostream>
 
 // namespace UserCommon_315634022 {
 
-ThreadPool::ThreadPool(size_t numThreads) {
+static thread_local int tlsPinnedCpu = -1;
+static thread_local int tlsWorker    = -1;
+
+int ThreadPool::currentCpu() {
+    return tlsPinnedCpu;
+}
+
+int ThreadPool::currentWorker() {
+    return tlsWorker;
+}
+
+ThreadPool::ThreadPool(size_t numThreads, std::vector<int> cpus)
+  : busy_(numThreads, Clock::duration::zero()),
+    busySince_(numThreads),
+    running_(numThreads, 0) {
     for (size_t i = 0; i < numThreads; ++i) {
-        workers_.emplace_back([this, i] {
+        int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        workers_.emplace_back([this, i, cpu] {
+            if (cpu >= 0 && pinCurrentThread(cpu)) tlsPinnedCpu = cpu;
+            tlsWorker = int(i);
             std::cout << "[ThreadPool] Worker " << i << " started [ID = "<< std::this_thread::get_id()<<"]\n";
             while (true) {
-                std::function<void()> task;
+                std::shared_ptr<Node> node;
                 {
                     std::unique_lock<std::mutex> lock(mutex_);
                     cond_.wait(lock, [this] {
-                        return stop_ || !tasks_.empty();
+                        return (stop_ && outstanding_ == 0) || !tasks_.empty();
                     });
-                    if (stop_ && tasks_.empty()) {
+                    if (tasks_.empty()) {
                         break;
                     }
-                    task = std::move(tasks_.front());
+                    node = std::move(tasks_.front());
                     tasks_.pop();
+                    busySince_[i] = Clock::now();
+                    running_[i]   = 1;
+                }
+                std::exception_ptr error = node->error;   // set: a dependency failed
+                if (!error) {
+                    try { node->fn(); }
+                    catch (...) { error = std::current_exception(); }
                 }
-                task();
+                node->fn = nullptr;   // drop captures before dependents run
+                finish(i, node, error);
             }
             std::cout << "[ThreadPool] Worker " << i << " exiting\n";
         });
@@ -31,12 +57,90 @@ ThreadPool::~ThreadPool() {
     shutdown();
 }
 
-void ThreadPool::enqueue(std::function<void()> task) {
+ThreadPool::TaskHandle ThreadPool::enqueue(std::function<void()> task,
+                                           const std::vector<TaskHandle>& after) {
+    auto node = std::make_shared<Node>();
+    node->fn = std::move(task);
+    bool runnable;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++outstanding_;
+        for (const TaskHandle& dep : after) {
+            if (!dep.node_) continue;
+            if (dep.node_->done) {
+                if (!node->error) node->error = dep.node_->error;
+            } else {
+                ++node->pending;
+                dep.node_->next.push_back(node);
+            }
+        }
+        runnable = node->pending == 0;
+        if (runnable) tasks_.push(node);
+    }
+    if (runnable) cond_.notify_one();
+    return TaskHandle(this, std::move(node));
+}
+
+void ThreadPool::finish(size_t worker, const std::shared_ptr<Node>& node, std::exception_ptr error) {
+    size_t woken = 0;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        tasks_.push(std::move(task));
+        busy_[worker]   += Clock::now() - busySince_[worker];
+        running_[worker] = 0;
+        node->done  = true;
+        node->error = error;
+        for (auto& succ : node->next) {
+            if (error && !succ->error) succ->error = error;
+            if (--succ->pending == 0) {
+                tasks_.push(succ);
+                ++woken;
+            }
+        }
+        node->next.clear();
+        if (--outstanding_ == 0 && stop_) woken = workers_.size();
+    }
+    doneCond_.notify_all();
+    if (woken >= workers_.size()) cond_.notify_all();
+    else for (size_t k = 0; k < woken; ++k) cond_.notify_one();
+}
+
+ThreadPool::Stats ThreadPool::stats() {
+    Stats st;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    size_t runningCount = 0;
+    for (size_t i = 0; i < busy_.size(); ++i) {
+        auto busy = busy_[i];
+        if (running_[i]) {
+            busy += now - busySince_[i];
+            ++runningCount;
+        }
+        st.busySeconds.push_back(std::chrono::duration<double>(busy).count());
+    }
+    st.queued  = tasks_.size();
+    st.waiting = outstanding_ - st.queued - runningCount;
+    return st;
+}
+
+bool ThreadPool::TaskHandle::ready() const {
+    if (!node_) return false;
+    std::lock_guard<std::mutex> lock(pool_->mutex_);
+    return node_->done;
+}
+
+void ThreadPool::TaskHandle::wait() const {
+    if (!node_) return;
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(pool_->mutex_);
+        pool_->doneCond_.wait(lock, [this] { return node_->done; });
+        error = node_->error;
     }
-    cond_.notify_one();
+    if (error) std::rethrow_exception(error);
+}
+
+ThreadPool::TaskHandle ThreadPool::TaskHandle::then(std::function<void()> next) const {
+    return pool_->enqueue(std::move(next), {*this});
 }
 
 void ThreadPool::shutdown() {
@@ -5,26 +5,93 @@
 #include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <memory>
 
 // namespace UserCommon_315634022 {
 
 // A fixed‐size thread‐pool. Enqueue tasks; they’ll run on worker threads.
+// A task may depend on earlier ones: it becomes runnable once they have all
+// finished, so loading, playing and folding can be chained as a graph.
 class ThreadPool {
+    struct Node;
+
 public:
-    explicit ThreadPool(size_t numThreads);
+    // Future-like handle to an enqueued task. Copies refer to the same task.
+    class TaskHandle {
+    public:
+        TaskHandle() = default;
+        bool valid() const { return node_ != nullptr; }
+
+        // True once the task has run (or was skipped after a failed dependency)
+        bool ready() const;
+
+        // Blocks until ready, then rethrows the task's exception, if any.
+        // Not for use inside a pool task: chain with then() or dependencies.
+        void wait() const;
+
+        // Runs `next` on the pool after this task
+        TaskHandle then(std::function<void()> next) const;
+
+    private:
+        friend class ThreadPool;
+        TaskHandle(ThreadPool* pool, std::shared_ptr<Node> node)
+          : pool_(pool), node_(std::move(node)) {}
+        ThreadPool*           pool_ = nullptr;
+        std::shared_ptr<Node> node_;
+    };
+
+    // With a non-empty `cpus`, worker i pins itself to cpus[i % cpus.size()]
+    explicit ThreadPool(size_t numThreads, std::vector<int> cpus = {});
     ~ThreadPool();
 
-    // Add a task to be run by the pool
-    void enqueue(std::function<void()> task);
+    // CPU the calling worker is pinned to; -1 off the pool or when unpinned
+    static int currentCpu();
 
-    // Stop accepting new tasks, finish all pending, and join threads
+    // Index of the calling worker in its pool; -1 off the pool. Async-signal-safe.
+    static int currentWorker();
+
+    // Add a task to be run by the pool once every task in `after` has
+    // finished. A task that throws keeps the exception in its handle, and the
+    // tasks depending on it are skipped and report the same exception.
+    TaskHandle enqueue(std::function<void()> task,
+                       const std::vector<TaskHandle>& after = {});
+
+    // Snapshot of the pool's load, for progress reporting
+    struct Stats {
+        size_t queued  = 0;                 // runnable, not yet started
+        size_t waiting = 0;                 // waiting on dependencies
+        std::vector<double> busySeconds;    // per worker, including the task it is running
+    };
+    Stats stats();
+
+    // Stop accepting new tasks, finish all pending (including those still
+    // waiting on dependencies), and join threads
     void shutdown();
 
 private:
+    struct Node {
+        std::function<void()>              fn;
+        size_t                             pending = 0;   // unfinished dependencies
+        bool                               done = false;
+        std::exception_ptr                 error;
+        std::vector<std::shared_ptr<Node>> next;          // tasks waiting on this one
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void finish(size_t worker, const std::shared_ptr<Node>& node, std::exception_ptr error);
+
     std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
+    std::queue<std::shared_ptr<Node>> tasks_;
     std::mutex mutex_;
     std::condition_variable cond_;
+    std::condition_variable doneCond_;   // some task finished
+    size_t outstanding_ = 0;             // enqueued and not yet finished
+    std::vector<Clock::duration>   busy_;        // per worker, finished tasks
+    std::vector<Clock::time_point> busySince_;   // per worker, start of the running task
+    std::vector<char>              running_;
     bool stop_ = false;
 };
 
@@ -0,0 +1,118 @@
+#include "TiledMap.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace UserCommon_315634022;
+
+// file layout: the directory (tilesX*tilesY entries), then the stored tiles
+TiledMapView::TiledMapView(int fd, std::size_t width, std::size_t height, std::size_t fileSize)
+  : width_(width), height_(height), tilesX_(tilesFor(width)), size_(fileSize)
+{
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error(std::string("Failed to map tiled map: ") + std::strerror(errno));
+    }
+    base_ = static_cast<const char*>(p);
+    dir_  = reinterpret_cast<const std::uint64_t*>(base_);
+}
+
+TiledMapView::~TiledMapView() {
+    ::munmap(const_cast<char*>(base_), size_);
+}
+
+TiledMapBuilder::TiledMapBuilder(std::size_t rows, std::size_t cols)
+  : rows_(rows), cols_(cols), tilesX_(tilesFor(cols)), tilesY_(tilesFor(rows)),
+    next_(tilesFor(cols) * tilesFor(rows) * sizeof(std::uint64_t)),
+    dir_(tilesX_ * tilesY_, 0)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "simmap.XXXXXX").string();
+    fd_ = ::mkstemp(&path[0]);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to create tiled map file '" + path + "': " + std::strerror(errno));
+    }
+    ::unlink(path.c_str());
+    band_.reserve(kTileSize);
+}
+
+TiledMapBuilder::~TiledMapBuilder() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+void TiledMapBuilder::writeAt(const void* data, std::size_t len, std::uint64_t off) {
+    auto p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::pwrite(fd_, p, len, off_t(off));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Tiled map write failed: ") + std::strerror(errno));
+        }
+        p += n; len -= std::size_t(n); off += std::uint64_t(n);
+    }
+}
+
+void TiledMapBuilder::addRow(const std::string& row) {
+    if (row.size() != cols_) {
+        std::ostringstream os;
+        os << "Map row " << rowsSeen_ << " length " << row.size() << " != Cols=" << cols_;
+        throw std::runtime_error(os.str());
+    }
+    if (rowsSeen_ == rows_) {
+        std::ostringstream os;
+        os << "Expected " << rows_ << " grid lines but found more";
+        throw std::runtime_error(os.str());
+    }
+    band_.push_back(row);
+    ++rowsSeen_;
+    if (band_.size() == kTileSize) flushBand();
+}
+
+// one tile row: uniform tiles go to the directory only, the others to the
+// file (padded with ' ' past the map's edge, which getObjectAt never reads)
+void TiledMapBuilder::flushBand() {
+    if (band_.empty()) return;
+    const std::size_t ty = (rowsSeen_ - 1) >> kTileShift;
+    std::vector<char> stored;
+    for (std::size_t tx = 0; tx < tilesX_; ++tx) {
+        const std::size_t x0 = tx << kTileShift;
+        const std::size_t w  = std::min(kTileSize, cols_ - x0);
+        const char first = band_[0][x0];
+        bool uniform = true;
+        for (std::size_t r = 0; r < band_.size() && uniform; ++r)
+            for (std::size_t i = 0; i < w && uniform; ++i)
+                uniform = band_[r][x0 + i] == first;
+        if (uniform) {
+            dir_[ty * tilesX_ + tx] = TiledMapView::kUniform | std::uint8_t(first);
+            continue;
+        }
+        std::size_t at = stored.size();
+        stored.resize(at + kTileCells, ' ');
+        for (std::size_t r = 0; r < band_.size(); ++r)
+            std::memcpy(&stored[at + (r << kTileShift)], band_[r].data() + x0, w);
+        dir_[ty * tilesX_ + tx] = next_ + at;
+    }
+    if (!stored.empty()) writeAt(stored.data(), stored.size(), next_);
+    next_ += stored.size();
+    band_.clear();
+}
+
+std::unique_ptr<TiledMapView> TiledMapBuilder::finish() {
+    if (rowsSeen_ != rows_) {
+        std::ostringstream os;
+        os << "Expected " << rows_ << " grid lines but found " << rowsSeen_;
+        throw std::runtime_error(os.str());
+    }
+    flushBand();
+    writeAt(dir_.data(), dir_.size() * sizeof(std::uint64_t), 0);
+    auto view = std::make_unique<TiledMapView>(fd_, cols_, rows_, std::size_t(next_));
+    ::close(fd_);   // the mapping keeps the (unlinked) file alive
+    fd_ = -1;
+    return view;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "SatelliteView.h"
+#include "TiledGrid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A map compiled into kTileSize×kTileSize tiles and read through mmap(): a
+// tile of a single kind of cell (open floor, solid rock) is stored as just
+// that char in the tile directory, any other is 4 KiB of cells in the file,
+// paged in when first read. Memory follows the map's content, not its area.
+// It carries no StaticMapAnalysis: on maps this size that would be the
+// dense copy the tiles avoid.
+class TiledMapView : public SatelliteView, public UserCommon_315634022::TileSource {
+public:
+    TiledMapView(int fd, std::size_t width, std::size_t height, std::size_t fileSize);
+    ~TiledMapView();
+
+    TiledMapView(const TiledMapView&) = delete;
+    TiledMapView& operator=(const TiledMapView&) = delete;
+
+    char getObjectAt(std::size_t x, std::size_t y) const override {
+        using namespace UserCommon_315634022;
+        if (x >= width_ || y >= height_) return ' ';
+        std::uint64_t e = dir_[(y >> kTileShift) * tilesX_ + (x >> kTileShift)];
+        if (e & kUniform) return char(e & 0xFF);
+        return base_[e + (((y & kTileMask) << kTileShift) | (x & kTileMask))];
+    }
+    bool uniformTile(std::size_t tx, std::size_t ty, char& fill) const override {
+        std::uint64_t e = dir_[ty * tilesX_ + tx];
+        fill = char(e & 0xFF);
+        return (e & kUniform) != 0;
+    }
+
+    std::size_t width()  const { return width_;  }
+    std::size_t height() const { return height_; }
+
+    // Directory entry flag: the tile is uniform, its char in the low byte;
+    // otherwise the entry is the file offset of the tile's cells.
+    static constexpr std::uint64_t kUniform = std::uint64_t(1) << 63;
+
+private:
+    std::size_t          width_, height_, tilesX_;
+    std::size_t          size_;
+    const char*          base_;
+    const std::uint64_t* dir_;
+};
+
+// Compiles a map grid row by row into a tiled file in the temp directory
+// ($TMPDIR, else /tmp), holding one band of kTileSize rows at a time. The
+// file is unlinked as soon as it is created, so it lives exactly as long as
+// the view that maps it; point TMPDIR at a disk, not tmpfs, for maps larger
+// than memory. Throws std::runtime_error on a malformed grid or I/O failure.
+class TiledMapBuilder {
+public:
+    TiledMapBuilder(std::size_t rows, std::size_t cols);
+    ~TiledMapBuilder();
+
+    TiledMapBuilder(const TiledMapBuilder&) = delete;
+    TiledMapBuilder& operator=(const TiledMapBuilder&) = delete;
+
+    void addRow(const std::string& row);
+    std::unique_ptr<TiledMapView> finish();
+
+private:
+    void flushBand();
+    void writeAt(const void* data, std::size_t len, std::uint64_t off);
+
+    std::size_t rows_, cols_, tilesX_, tilesY_;
+    int         fd_ = -1;
+    std::size_t rowsSeen_ = 0;
+    std::uint64_t next_;                 // file offset of the next stored tile
+    std::vector<std::uint64_t> dir_;
+    std::vector<std::string>   band_;    // rows of the current band
+};
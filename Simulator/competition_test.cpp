@@ -0,0 +1,206 @@
+// Simulator/competition_test.cpp
+//
+// Known-answer checks of the competition-mode arithmetic: the early-stop
+// sequential test, Bradley-Terry ratings, Swiss pairing and shard assignment.
+// Prints every failed check and exits non-zero if there was one.
+//
+//   competition_test
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Ratings.hpp"
+#include "Sharding.hpp"
+
+namespace {
+
+int checks = 0, failures = 0;
+
+void check(bool ok, const std::string& what) {
+    ++checks;
+    if (ok) return;
+    ++failures;
+    std::cout << "[competition_test] FAILED: " << what << "\n";
+}
+
+const char* name(PairVerdict v) {
+    switch (v) {
+    case PairVerdict::FirstStronger:  return "FirstStronger";
+    case PairVerdict::SecondStronger: return "SecondStronger";
+    case PairVerdict::Even:           return "Even";
+    case PairVerdict::Open:           return "Open";
+    }
+    return "?";
+}
+
+void checkVerdict(std::size_t w, std::size_t l, std::size_t d, double confidence, PairVerdict want) {
+    PairVerdict got = sequentialTest(w, l, d, confidence);
+    check(got == want, "sequentialTest(W/L/D=" + std::to_string(w) + "/" + std::to_string(l) + "/" +
+                       std::to_string(d) + ", " + std::to_string(confidence) + ") = " + name(got) +
+                       ", expected " + name(want));
+}
+
+using Pairs = std::vector<std::pair<std::size_t, std::size_t>>;
+
+std::string str(const Pairs& pairs) {
+    std::string s;
+    for (auto& p : pairs) s += "(" + std::to_string(p.first) + "," + std::to_string(p.second) + ")";
+    return s;
+}
+
+//------------------------------------------------------------------------------
+// sequentialTest: at confidence 0.95 the bound is ln 19, a win from the first
+// side's view adds ln 1.4 and a loss ln 0.6, a draw half of each
+//------------------------------------------------------------------------------
+void testSequential() {
+    // ln 19 / ln 1.4 = 8.75: the 9th straight win decides
+    checkVerdict(8, 0, 0, 0.95, PairVerdict::Open);
+    checkVerdict(9, 0, 0, 0.95, PairVerdict::FirstStronger);
+    checkVerdict(0, 8, 0, 0.95, PairVerdict::Open);
+    checkVerdict(0, 9, 0, 0.95, PairVerdict::SecondStronger);
+
+    // ln 19 / (ln 1.4 + ln 0.6)/2 = 33.8 draws (or win-loss pairs) for even
+    checkVerdict(0, 0, 33, 0.95, PairVerdict::Open);
+    checkVerdict(0, 0, 34, 0.95, PairVerdict::Even);
+    checkVerdict(16, 16, 0, 0.95, PairVerdict::Open);
+    checkVerdict(17, 17, 0, 0.95, PairVerdict::Even);
+
+    // losses offset wins: 9 wins and a loss are no longer enough
+    checkVerdict(9, 1, 0, 0.95, PairVerdict::Open);
+    checkVerdict(11, 1, 0, 0.95, PairVerdict::FirstStronger);
+
+    // a lower confidence decides sooner: ln 9 / ln 1.4 = 6.5
+    checkVerdict(6, 0, 0, 0.90, PairVerdict::Open);
+    checkVerdict(7, 0, 0, 0.90, PairVerdict::FirstStronger);
+
+    double reached = 0;
+    sequentialTest(9, 0, 0, 0.95, &reached);
+    check(reached >= 0.95 && reached < 1, "posterior of a decided pair is at least its confidence");
+    sequentialTest(0, 0, 0, 0.95, &reached);
+    check(std::fabs(reached - 0.5) < 1e-12, "posterior before any game is 0.5");
+}
+
+//------------------------------------------------------------------------------
+// rateGames
+//------------------------------------------------------------------------------
+void testRatings() {
+    // no games: everyone holds the anchor's 1500
+    auto none = rateGames(2, {});
+    check(none.size() == 2 && none[0].elo == 1500 && none[1].elo == 1500, "ratings without games are 1500");
+
+    // one win each way: even, and on the anchor
+    auto even = rateGames(2, {{0, 1, 1}, {1, 0, 1}});
+    check(std::fabs(even[0].elo - 1500) < 1e-6 && std::fabs(even[1].elo - 1500) < 1e-6,
+          "one win each way rates both 1500");
+
+    // 0 beats 1 three times. By symmetry their log-strengths are r and -r,
+    // and the likelihood's optimum has 3 + 1/2 = 3·σ(2r) + σ(r) (0's score,
+    // virtual draw included, equals its expected score), so r = 1.170676:
+    // 1500 ± 400·r/ln 10
+    auto three = rateGames(2, {{0, 1, 1}, {0, 1, 1}, {1, 0, 0}});
+    check(std::fabs(three[0].elo - 1703.367) < 0.01, "3-0 winner rated 1703.37, got " + std::to_string(three[0].elo));
+    check(std::fabs(three[1].elo - 1296.633) < 0.01, "3-0 loser rated 1296.63, got " + std::to_string(three[1].elo));
+    check(three[0].wins == 3 && three[0].losses == 0 && three[1].losses == 3, "3-0 W/L counts");
+    check(three[0].ci95 > 0 && std::fabs(three[0].ci95 - three[1].ci95) < 1e-6, "3-0 intervals are equal and positive");
+
+    // a chain 0 > 1 > 2 with a draw; the order of the games does not matter
+    std::vector<RatedGame> games = {{0, 1, 1}, {1, 2, 1}, {0, 2, 0.5}, {0, 1, 1}, {2, 1, 0}, {0, 2, 1}};
+    auto chain = rateGames(3, games);
+    check(chain[0].elo > chain[1].elo && chain[1].elo > chain[2].elo, "chain ratings are ordered 0 > 1 > 2");
+    check(chain[0].draws == 1 && chain[2].draws == 1 && chain[1].draws == 0, "draws counted on both sides");
+    std::reverse(games.begin(), games.end());
+    auto reversed = rateGames(3, games);
+    bool same = true;
+    for (std::size_t i = 0; i < 3; ++i) same = same && std::fabs(chain[i].elo - reversed[i].elo) < 1e-6;
+    check(same, "ratings do not depend on the order of the games");
+}
+
+//------------------------------------------------------------------------------
+// swissPairs
+//------------------------------------------------------------------------------
+void testSwiss() {
+    // four players rated 0 > 1 > 2 > 3: three rounds without a rematch, each
+    // pairing the best with the best-rated opponent it has not met, and only
+    // then the first rematch
+    const std::vector<double> rating = {4, 3, 2, 1};
+    std::vector<std::vector<unsigned>> met(4, std::vector<unsigned>(4, 0));
+    std::vector<unsigned> byes(4, 0);
+    const Pairs want[] = {
+        {{0, 1}, {2, 3}},
+        {{0, 2}, {1, 3}},
+        {{0, 3}, {1, 2}},
+        {{0, 1}, {2, 3}},
+    };
+    for (int round = 0; round < 4; ++round) {
+        Pairs got = swissPairs(rating, met, byes);
+        check(got == want[round], "swiss round " + std::to_string(round + 1) + ": " + str(got) +
+                                  ", expected " + str(want[round]));
+        for (auto& p : got) {
+            if (round < 3) check(met[p.first][p.second] == 0, "no rematch while unmet opponents remain");
+            ++met[p.first][p.second];
+            ++met[p.second][p.first];
+        }
+    }
+    check(byes == std::vector<unsigned>(4, 0), "no byes with an even count");
+
+    // three players: the bye goes to the lowest-rated player with the
+    // fewest byes, so it rotates 2, 1, 0 and then starts over
+    const std::vector<double> three = {3, 2, 1};
+    std::vector<std::vector<unsigned>> met3(3, std::vector<unsigned>(3, 0));
+    std::vector<unsigned> byes3(3, 0);
+    const std::size_t wantBye[] = {2, 1, 0, 2};
+    for (int round = 0; round < 4; ++round) {
+        std::vector<unsigned> before = byes3;
+        Pairs got = swissPairs(three, met3, byes3);
+        check(got.size() == 1, "one pair of three players per round");
+        std::size_t sat = 3;
+        for (std::size_t i = 0; i < 3; ++i)
+            if (byes3[i] != before[i]) sat = i;
+        check(sat == wantBye[round], "swiss bye in round " + std::to_string(round + 1) + " went to " +
+                                     std::to_string(sat) + ", expected " + std::to_string(wantBye[round]));
+        for (auto& p : got) check(p.first != sat && p.second != sat, "the player on a bye is not paired");
+    }
+
+    check(defaultSwissRounds(2) == 2 && defaultSwissRounds(5) == 6 && defaultSwissRounds(8) == 6,
+          "default rounds are 2·ceil(log2 n)");
+}
+
+//------------------------------------------------------------------------------
+// assignShards
+//------------------------------------------------------------------------------
+void testShards() {
+    // heaviest first onto the least-loaded shard, ties to the lower index:
+    // 5→0, 3→1, 3→1, 2→0, 1→1, 1→0, leaving loads 8 and 7
+    const std::vector<double> costs = {5, 3, 3, 2, 1, 1};
+    const std::vector<std::size_t> want = {0, 1, 1, 0, 1, 0};
+    check(assignShards(costs, 2) == want, "two-shard assignment of 5,3,3,2,1,1");
+    check(assignShards(costs, 2) == assignShards(costs, 2), "assignment is the same on every call");
+
+    // equal costs: dealt out in index order
+    check(assignShards({1, 1, 1, 1, 1}, 3) == std::vector<std::size_t>({0, 1, 2, 0, 1}),
+          "equal costs go round-robin by index");
+    check(assignShards(costs, 1) == std::vector<std::size_t>(costs.size(), 0), "one shard takes every task");
+
+    // more shards than tasks: each task alone, nothing out of range
+    auto wide = assignShards({2, 7, 1}, 8);
+    check(wide == std::vector<std::size_t>({1, 0, 2}), "more shards than tasks");
+}
+
+} // namespace
+
+int main() {
+    testSequential();
+    testRatings();
+    testSwiss();
+    testShards();
+    if (failures > 0) {
+        std::cout << "[competition_test] " << failures << " of " << checks << " checks failed\n";
+        return 1;
+    }
+    std::cout << "[competition_test] OK: " << checks << " checks\n";
+    return 0;
+}
@@ -0,0 +1,596 @@
+// Simulator/diff_test.cpp
+//
+// Differential test of game managers. Random maps and scripted random tanks;
+// every game is played by a reference GM (run(), one game at a time,
+// sequential decisions, generic engine) and by a candidate (runBatch() on
+// batch_size games sharing a map, decisions on decision_threads threads, the
+// engine it picks for the map size), and both must agree
+// on winner, reason, rounds, remaining tanks, the final board and every board
+// a tank was shown along the way. A mismatch is shrunk to a small map and
+// action script and printed in map-file form.
+//
+// The reference defaults to the frozen pre-batching GM built from
+// fixtures/sequential_gm, which plays exactly one tank a side; max_tanks=
+// above 1 allows up to that many (or none) a side, for a reference that
+// plays them. There is no frozen multi-tank GM, so those runs can only check
+// a GM against its own run().
+//
+//   diff_test [reference=<gm.so>] [candidate=<gm.so>] [games=<N>] [seed=<S>]
+//             [batch_size=<K>] [decision_threads=<N>] [max_tanks=<N>]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "GameManagerRegistrar.h"
+#include "Hashing.hpp"
+#include "BatchGameManager.h"
+#include "DeltaSatelliteView.h"
+
+using UserCommon_315634022::BatchGame;
+using UserCommon_315634022::BatchGameManager;
+using UserCommon_315634022::DeltaSatelliteView;
+
+namespace {
+
+const char* const kActionNames[] = {
+    "MoveForward", "MoveBackward", "RotateLeft90", "RotateRight90",
+    "RotateLeft45", "RotateRight45", "Shoot", "GetBattleInfo", "DoNothing"
+};
+
+using Script  = std::vector<ActionRequest>;   // one tank: its action on each turn
+using Scripts = std::vector<Script>;          // one player's tanks, in spawn order
+
+struct GameSpec {
+    Scripts side[2];
+};
+
+// Games sharing a map and parameters: what one runBatch() call plays
+struct BatchSpec {
+    std::vector<std::string> rows;
+    size_t maxSteps = 0, numShells = 0;
+    std::vector<GameSpec> games;
+};
+
+class RowsView : public SatelliteView {
+public:
+    explicit RowsView(const std::vector<std::string>& rows) : rows_(rows) {}
+    char getObjectAt(size_t x, size_t y) const override {
+        return (y < rows_.size() && x < rows_[y].size()) ? rows_[y][x] : ' ';
+    }
+private:
+    const std::vector<std::string>& rows_;
+};
+
+// A board shown to a tank: who asked, after how many of its turns, and a hash.
+// Cells are kNone, kMany or y * w + x: where the board marks the asking tank
+// '%', and where the view says it stands (DeltaSatelliteView::selfPosition).
+struct Sighting {
+    static constexpr std::int64_t kNone = -1, kMany = -2;
+    int player;
+    size_t tank, turn;
+    std::uint64_t board;
+    std::int64_t marked = kNone, position = kNone;
+    bool operator<(const Sighting& o) const {
+        if (turn != o.turn)     return turn < o.turn;
+        if (player != o.player) return player < o.player;
+        if (tank != o.tank)     return tank < o.tank;
+        return board < o.board;
+    }
+    bool operator==(const Sighting& o) const {
+        return turn == o.turn && player == o.player && tank == o.tank && board == o.board;
+    }
+};
+
+struct Outcome {
+    int winner = 0, reason = 0;
+    size_t rounds = 0;
+    std::vector<size_t> remaining;
+    std::vector<std::string> board;        // final state
+    std::vector<Sighting> sightings;       // sorted
+    std::string error;                     // what the GM threw, if it did
+};
+
+class ScriptedTank : public TankAlgorithm {
+public:
+    ScriptedTank(const Script& script, size_t index) : script_(script), index_(index) {}
+    ActionRequest getAction() override {
+        ActionRequest a = turn_ < script_.size() ? script_[turn_] : ActionRequest::DoNothing;
+        ++turn_;
+        return a;
+    }
+    void updateBattleInfo(BattleInfo&) override {}
+    size_t index() const { return index_; }
+    size_t turn()  const { return turn_; }
+private:
+    const Script& script_;
+    size_t index_;
+    size_t turn_ = 0;
+};
+
+class RecordingPlayer : public Player {
+public:
+    RecordingPlayer(int player, size_t w, size_t h) : player_(player), w_(w), h_(h) {}
+    void updateTankWithBattleInfo(TankAlgorithm& tank, SatelliteView& view) override {
+        auto* t = dynamic_cast<ScriptedTank*>(&tank);
+        Sighting s{player_, t ? t->index() : SIZE_MAX, t ? t->turn() : 0, kFnvOffset};
+        for (size_t y = 0; y < h_; ++y)
+            for (size_t x = 0; x < w_; ++x) {
+                char c = view.getObjectAt(x, y);
+                s.board = fnv1a(&c, 1, s.board);
+                if (c == '%')
+                    s.marked = s.marked == Sighting::kNone ? std::int64_t(y * w_ + x) : Sighting::kMany;
+            }
+        size_t x, y;
+        auto* delta = dynamic_cast<DeltaSatelliteView*>(&view);
+        if (delta && delta->selfPosition(x, y)) s.position = std::int64_t(y * w_ + x);
+        sightings.push_back(s);
+    }
+    std::vector<Sighting> sightings;
+private:
+    int player_;
+    size_t w_, h_;
+};
+
+const Script kNoScript;
+
+TankAlgorithmFactory scriptedFactory(const Scripts& scripts) {
+    return [&scripts](int, int ti) -> std::unique_ptr<TankAlgorithm> {
+        size_t k = size_t(ti);
+        return std::make_unique<ScriptedTank>(k < scripts.size() ? scripts[k] : kNoScript, k);
+    };
+}
+
+size_t countOf(const std::vector<std::string>& rows, char c) {
+    size_t n = 0;
+    for (auto& r : rows) n += size_t(std::count(r.begin(), r.end(), c));
+    return n;
+}
+
+Outcome collect(GameResult& gr, const BatchSpec& b, RecordingPlayer& p1, RecordingPlayer& p2) {
+    Outcome o;
+    o.winner    = gr.winner;
+    o.reason    = int(gr.reason);
+    o.rounds    = gr.rounds;
+    o.remaining = gr.remaining_tanks;
+    const size_t h = b.rows.size(), w = b.rows[0].size();
+    if (gr.gameState) {
+        for (size_t y = 0; y < h; ++y) {
+            std::string row;
+            for (size_t x = 0; x < w; ++x) row += gr.gameState->getObjectAt(x, y);
+            o.board.push_back(std::move(row));
+        }
+    }
+    o.sightings = p1.sightings;
+    o.sightings.insert(o.sightings.end(), p2.sightings.begin(), p2.sightings.end());
+    std::sort(o.sightings.begin(), o.sightings.end());
+    return o;
+}
+
+// First difference between two outcomes, empty if there is none
+std::string compare(const Outcome& ref, const Outcome& cand) {
+    std::ostringstream os;
+    if (ref.error != cand.error) {
+        os << "exception: reference '" << ref.error << "' vs candidate '" << cand.error << "'";
+        return os.str();
+    }
+    const size_t n = std::min(ref.sightings.size(), cand.sightings.size());
+    for (size_t k = 0; k < n; ++k) {
+        const Sighting& a = ref.sightings[k];
+        const Sighting& b = cand.sightings[k];
+        if (a == b) {
+            // a '%' marks the asking tank and nothing else: one cell, where
+            // the reference has that tank
+            if (b.marked == Sighting::kNone || (b.marked >= 0 && b.marked == a.position)) continue;
+            os << "self marker: candidate player " << b.player + 1 << " tank " << b.tank
+               << " turn " << b.turn << " marks "
+               << (b.marked == Sighting::kMany ? std::string("several cells") : "cell " + std::to_string(b.marked))
+               << ", reference tank at "
+               << (a.position < 0 ? std::string("(unknown)") : "cell " + std::to_string(a.position));
+            return os.str();
+        }
+        os << "board shown differs: reference player " << a.player + 1 << " tank " << a.tank
+           << " turn " << a.turn << " [" << toHex(a.board) << "] vs candidate player "
+           << b.player + 1 << " tank " << b.tank << " turn " << b.turn << " [" << toHex(b.board) << "]";
+        return os.str();
+    }
+    if (ref.sightings.size() != cand.sightings.size()) {
+        os << "boards shown: reference " << ref.sightings.size()
+           << " vs candidate " << cand.sightings.size();
+        return os.str();
+    }
+    if (ref.winner != cand.winner || ref.reason != cand.reason || ref.rounds != cand.rounds) {
+        os << "result: reference winner=" << ref.winner << " reason=" << ref.reason
+           << " rounds=" << ref.rounds << " vs candidate winner=" << cand.winner
+           << " reason=" << cand.reason << " rounds=" << cand.rounds;
+        return os.str();
+    }
+    if (ref.remaining != cand.remaining) return "remaining_tanks differ";
+    if (ref.board != cand.board) {
+        os << "final board differs:\n";
+        for (size_t y = 0; y < std::max(ref.board.size(), cand.board.size()); ++y) {
+            os << "    " << (y < ref.board.size() ? ref.board[y] : "") << "   "
+               << (y < cand.board.size() ? cand.board[y] : "") << "\n";
+        }
+        return os.str();
+    }
+    return "";
+}
+
+class Harness {
+public:
+    Harness(GameManagerFactory ref, GameManagerFactory cand, int decisionThreads)
+      : ref_(std::move(ref)), cand_(std::move(cand)), threads_(decisionThreads) {}
+
+    // Game `gi` of `b` alone on the reference GM, sequential decisions, on
+    // the generic engine rather than a fixed-size one
+    Outcome reference(const BatchSpec& b, size_t gi) const {
+        unsetenv("SIM_DECISION_THREADS");
+        setenv("SIM_GENERIC_ENGINE", "1", 1);
+        const GameSpec& g = b.games[gi];
+        const size_t w = b.rows[0].size(), h = b.rows.size();
+        RowsView map(b.rows);
+        RecordingPlayer p1(0, w, h), p2(1, w, h);
+        auto gm = ref_(false);
+        try {
+            GameResult gr = gm->run(w, h, map, "diff_test", b.maxSteps, b.numShells,
+                                    p1, "scripted1", p2, "scripted2",
+                                    scriptedFactory(g.side[0]), scriptedFactory(g.side[1]));
+            return collect(gr, b, p1, p2);
+        } catch (const std::exception& ex) {
+            Outcome o;
+            o.error = ex.what();
+            return o;
+        }
+    }
+
+    // Every game of `b` on the candidate GM: one runBatch() when it is a
+    // BatchGameManager, else run() per game
+    std::vector<Outcome> candidate(const BatchSpec& b) const {
+        if (threads_ > 1) setenv("SIM_DECISION_THREADS", std::to_string(threads_).c_str(), 1);
+        else              unsetenv("SIM_DECISION_THREADS");
+        unsetenv("SIM_GENERIC_ENGINE");
+        const size_t w = b.rows[0].size(), h = b.rows.size();
+        RowsView map(b.rows);
+        std::vector<std::unique_ptr<RecordingPlayer>> players;
+        std::vector<BatchGame> games;
+        for (const GameSpec& g : b.games) {
+            players.push_back(std::make_unique<RecordingPlayer>(0, w, h));
+            players.push_back(std::make_unique<RecordingPlayer>(1, w, h));
+            games.push_back({players[players.size() - 2].get(), "scripted1",
+                             players[players.size() - 1].get(), "scripted2",
+                             scriptedFactory(g.side[0]), scriptedFactory(g.side[1])});
+        }
+
+        std::vector<Outcome> out(b.games.size());
+        auto gm = cand_(false);
+        try {
+            if (auto* batched = dynamic_cast<BatchGameManager*>(gm.get())) {
+                auto results = batched->runBatch(w, h, map, "diff_test", b.maxSteps, b.numShells, games);
+                for (size_t k = 0; k < results.size() && k < out.size(); ++k)
+                    out[k] = collect(results[k], b, *players[2 * k], *players[2 * k + 1]);
+            } else {
+                for (size_t k = 0; k < games.size(); ++k) {
+                    if (!gm) gm = cand_(false);   // a fresh GM per game
+                    GameResult gr = gm->run(w, h, map, "diff_test", b.maxSteps, b.numShells,
+                                            *games[k].player1, games[k].name1,
+                                            *games[k].player2, games[k].name2,
+                                            games[k].factory1, games[k].factory2);
+                    out[k] = collect(gr, b, *players[2 * k], *players[2 * k + 1]);
+                    gm.reset();
+                }
+            }
+        } catch (const std::exception& ex) {
+            for (auto& o : out) {
+                o = Outcome{};
+                o.error = ex.what();
+            }
+        }
+        return out;
+    }
+
+    std::string mismatch(const BatchSpec& b, size_t gi) const {
+        return compare(reference(b, gi), candidate(b)[gi]);
+    }
+
+private:
+    GameManagerFactory ref_, cand_;
+    int threads_;
+};
+
+//------------------------------------------------------------------------------
+// Random cases
+//------------------------------------------------------------------------------
+ActionRequest randomAction(std::mt19937_64& rng) {
+    // moves, shots and battle-info requests (which record a board) dominate
+    std::discrete_distribution<int> pick({4, 2, 1, 1, 1, 1, 3, 3, 1});
+    return ActionRequest(pick(rng));
+}
+
+Scripts randomScripts(std::mt19937_64& rng, size_t tanks, size_t turns) {
+    Scripts s(tanks);
+    for (auto& script : s)
+        for (size_t t = 0; t < turns; ++t) script.push_back(randomAction(rng));
+    return s;
+}
+
+// A map has 1..maxTanks tanks a side, now and then none; with maxTanks 1,
+// exactly one
+BatchSpec randomBatch(std::mt19937_64& rng, size_t games, size_t maxTanks) {
+    auto uni = [&](size_t lo, size_t hi) { return std::uniform_int_distribution<size_t>(lo, hi)(rng); };
+    BatchSpec b;
+    // mostly small maps; now and then one past 32×32, for the generic engine
+    const size_t side = uni(0, 7) == 0 ? 40 : 14;
+    const size_t w = uni(3, side), h = uni(3, side);
+    b.rows.assign(h, std::string(w, '.'));
+    for (auto& r : b.rows)
+        for (char& c : r) {
+            size_t roll = uni(0, 99);
+            c = roll < 12 ? '#' : roll < 18 ? '@' : '.';
+        }
+    for (char side : {'1', '2'}) {
+        size_t n = maxTanks == 1 ? 1 : uni(0, 19) == 0 ? 0 : uni(1, maxTanks);
+        for (size_t k = 0; k < n && countOf(b.rows, '1') + countOf(b.rows, '2') < w * h; ) {
+            char& c = b.rows[uni(0, h - 1)][uni(0, w - 1)];
+            if (c == '1' || c == '2') continue;   // one tank a cell
+            c = side;
+            ++k;
+        }
+    }
+    b.maxSteps  = uni(1, 60);
+    b.numShells = uni(0, 6);
+    const size_t t1 = countOf(b.rows, '1'), t2 = countOf(b.rows, '2');
+    for (size_t g = 0; g < games; ++g) {
+        GameSpec spec;
+        spec.side[0] = randomScripts(rng, t1, b.maxSteps);
+        spec.side[1] = randomScripts(rng, t2, b.maxSteps);
+        b.games.push_back(std::move(spec));
+    }
+    return b;
+}
+
+//------------------------------------------------------------------------------
+// Shrinking: greedy passes over smaller variants of the failing batch, keeping
+// any that still fails (with any mismatch), until none does
+//------------------------------------------------------------------------------
+
+// Map edits keep each tank's script with the tank: cells carry the spawn
+// index of the tank on them, so removed tanks drop out of every game.
+struct Cell { char c; int tank; };
+using Grid = std::vector<std::vector<Cell>>;
+
+Grid toGrid(const std::vector<std::string>& rows) {
+    Grid g;
+    int next[2] = {0, 0};
+    for (auto& r : rows) {
+        g.emplace_back();
+        for (char c : r) {
+            int side = c == '1' ? 0 : c == '2' ? 1 : -1;
+            g.back().push_back({c, side < 0 ? -1 : next[side]++});
+        }
+    }
+    return g;
+}
+
+BatchSpec fromGrid(const BatchSpec& b, const Grid& g) {
+    BatchSpec out = b;
+    out.rows.clear();
+    std::vector<int> kept[2];
+    for (auto& r : g) {
+        std::string row;
+        for (const Cell& cell : r) {
+            row += cell.c;
+            if (cell.c == '1') kept[0].push_back(cell.tank);
+            if (cell.c == '2') kept[1].push_back(cell.tank);
+        }
+        out.rows.push_back(std::move(row));
+    }
+    for (size_t gi = 0; gi < out.games.size(); ++gi)
+        for (int s = 0; s < 2; ++s) {
+            Scripts scripts;
+            for (int k : kept[s]) scripts.push_back(b.games[gi].side[s][size_t(k)]);
+            out.games[gi].side[s] = std::move(scripts);
+        }
+    return out;
+}
+
+struct Failure {
+    BatchSpec batch;
+    size_t game;
+};
+
+// Variants keep what randomBatch() promises the reference: with maxTanks 1,
+// one tank a side
+Failure shrink(const Harness& h, Failure f, size_t maxTanks) {
+    auto fails = [&](const BatchSpec& b, size_t gi) { return !h.mismatch(b, gi).empty(); };
+    auto playable = [&](const BatchSpec& b) {
+        return maxTanks != 1 || (countOf(b.rows, '1') == 1 && countOf(b.rows, '2') == 1);
+    };
+    auto accept = [&](BatchSpec b, size_t gi) {
+        if (!playable(b) || !fails(b, gi)) return false;
+        f = {std::move(b), gi};
+        return true;
+    };
+
+    for (bool progress = true; progress; ) {
+        progress = false;
+
+        // other games of the batch
+        for (size_t j = 0; j < f.batch.games.size() && f.batch.games.size() > 1; ) {
+            if (j == f.game) { ++j; continue; }
+            BatchSpec b = f.batch;
+            b.games.erase(b.games.begin() + long(j));
+            if (accept(std::move(b), f.game - (j < f.game ? 1 : 0))) progress = true;
+            else ++j;
+        }
+
+        // parameters
+        for (size_t s : {size_t(1), f.batch.maxSteps / 2, f.batch.maxSteps - 1}) {
+            if (s == 0 || s >= f.batch.maxSteps) continue;
+            BatchSpec b = f.batch;
+            b.maxSteps = s;
+            if (accept(std::move(b), f.game)) { progress = true; break; }
+        }
+        for (size_t s : {size_t(0), f.batch.numShells / 2, f.batch.numShells - 1}) {
+            if (f.batch.numShells == 0 || s >= f.batch.numShells) continue;
+            BatchSpec b = f.batch;
+            b.numShells = s;
+            if (accept(std::move(b), f.game)) { progress = true; break; }
+        }
+
+        // map: drop whole rows and columns, then clear single cells
+        for (size_t y = 0; y < f.batch.rows.size() && f.batch.rows.size() > 1; ) {
+            Grid g = toGrid(f.batch.rows);
+            g.erase(g.begin() + long(y));
+            if (accept(fromGrid(f.batch, g), f.game)) progress = true;
+            else ++y;
+        }
+        for (size_t x = 0; x < f.batch.rows[0].size() && f.batch.rows[0].size() > 1; ) {
+            Grid g = toGrid(f.batch.rows);
+            for (auto& r : g) r.erase(r.begin() + long(x));
+            if (accept(fromGrid(f.batch, g), f.game)) progress = true;
+            else ++x;
+        }
+        for (size_t y = 0; y < f.batch.rows.size(); ++y)
+            for (size_t x = 0; x < f.batch.rows[y].size(); ++x) {
+                if (f.batch.rows[y][x] == '.') continue;
+                Grid g = toGrid(f.batch.rows);
+                g[y][x].c = '.';
+                if (accept(fromGrid(f.batch, g), f.game)) progress = true;
+            }
+
+        // scripts: cut trailing turns, then turn single actions into DoNothing
+        for (size_t gi = 0; gi < f.batch.games.size(); ++gi)
+            for (int s = 0; s < 2; ++s)
+                for (size_t k = 0; k < f.batch.games[gi].side[s].size(); ++k) {
+                    for (size_t len = 0; len < f.batch.games[gi].side[s][k].size(); len = len ? len * 2 : 1) {
+                        BatchSpec b = f.batch;
+                        b.games[gi].side[s][k].resize(len);
+                        if (accept(std::move(b), f.game)) { progress = true; break; }
+                    }
+                    for (size_t t = 0; t < f.batch.games[gi].side[s][k].size(); ++t) {
+                        if (f.batch.games[gi].side[s][k][t] == ActionRequest::DoNothing) continue;
+                        BatchSpec b = f.batch;
+                        b.games[gi].side[s][k][t] = ActionRequest::DoNothing;
+                        if (accept(std::move(b), f.game)) progress = true;
+                    }
+                }
+    }
+    return f;
+}
+
+void printCase(std::ostream& out, const Failure& f) {
+    const BatchSpec& b = f.batch;
+    out << "--- map (save as a map file to replay) ---\n"
+        << "diff_test case\n"
+        << "MaxSteps = "  << b.maxSteps  << "\n"
+        << "NumShells = " << b.numShells << "\n"
+        << "Rows = "      << b.rows.size() << "\n"
+        << "Cols = "      << b.rows[0].size() << "\n";
+    for (auto& r : b.rows) out << r << "\n";
+    out << "--- scripts (turn:action; other turns DoNothing) ---\n";
+    for (size_t gi = 0; gi < b.games.size(); ++gi) {
+        out << "game " << gi << (gi == f.game ? " (failing)" : "") << "\n";
+        for (int s = 0; s < 2; ++s)
+            for (size_t k = 0; k < b.games[gi].side[s].size(); ++k) {
+                out << "  player " << s + 1 << " tank " << k << ":";
+                const Script& script = b.games[gi].side[s][k];
+                for (size_t t = 0; t < script.size(); ++t)
+                    if (script[t] != ActionRequest::DoNothing)
+                        out << " " << t << ":" << kActionNames[int(script[t])];
+                out << "\n";
+            }
+    }
+}
+
+GameManagerFactory loadGameManager(const std::string& path) {
+    auto& reg = GameManagerRegistrar::get();
+    reg.createGameManagerEntry(path);
+    if (!dlopen(path.c_str(), RTLD_NOW)) {
+        reg.removeLast();
+        throw std::runtime_error("dlopen '" + path + "' failed: " + dlerror());
+    }
+    try { reg.validateLastRegistration(); }
+    catch (const GameManagerRegistrar::BadRegistrationException&) {
+        reg.removeLast();
+        throw std::runtime_error("no game manager registered by '" + path + "'");
+    }
+    return (reg.begin() + long(reg.count() - 1))->factory;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string reference = "fixtures/sequential_gm/libGameManager_sequential.so";
+    std::string candidate = "../GameManager/sos/libGameManager_315634022.so";
+    size_t games = 300, batchSize = 4, maxTanks = 1;
+    std::uint64_t seed = 1;
+    int decisionThreads = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* key) { return arg.substr(std::string(key).size()); };
+        try {
+            if      (arg.rfind("reference=", 0) == 0)        reference = value("reference=");
+            else if (arg.rfind("candidate=", 0) == 0)        candidate = value("candidate=");
+            else if (arg.rfind("games=", 0) == 0)            games = std::stoul(value("games="));
+            else if (arg.rfind("seed=", 0) == 0)             seed = std::stoull(value("seed="));
+            else if (arg.rfind("batch_size=", 0) == 0)       batchSize = std::stoul(value("batch_size="));
+            else if (arg.rfind("decision_threads=", 0) == 0) decisionThreads = std::stoi(value("decision_threads="));
+            else if (arg.rfind("max_tanks=", 0) == 0)        maxTanks = std::stoul(value("max_tanks="));
+            else throw std::invalid_argument(arg);
+        } catch (const std::exception&) {
+            std::cerr << "Usage: " << argv[0] << " [reference=<gm.so>] [candidate=<gm.so>] [games=<N>]"
+                      << " [seed=<S>] [batch_size=<K>] [decision_threads=<N>] [max_tanks=<N>]\n";
+            return 2;
+        }
+    }
+    if (batchSize == 0) batchSize = 1;
+    if (maxTanks == 0) maxTanks = 1;
+
+    GameManagerFactory refFactory, candFactory;
+    try {
+        refFactory  = loadGameManager(reference);
+        candFactory = candidate == reference ? refFactory : loadGameManager(candidate);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 2;
+    }
+    Harness harness(refFactory, candFactory, decisionThreads);
+
+    std::mt19937_64 rng(seed);
+    size_t played = 0;
+    for (size_t bi = 0; played < games; ++bi) {
+        BatchSpec b = randomBatch(rng, std::min(batchSize, games - played), maxTanks);
+        std::vector<Outcome> cand = harness.candidate(b);
+        for (size_t gi = 0; gi < b.games.size(); ++gi) {
+            std::string diff = compare(harness.reference(b, gi), cand[gi]);
+            if (diff.empty()) continue;
+
+            std::cout << "[diff_test] MISMATCH in game " << gi << " of batch " << bi
+                      << " (seed=" << seed << "): " << diff << "\n";
+            Failure f = shrink(harness, Failure{b, gi}, maxTanks);
+            std::string why = harness.mismatch(f.batch, f.game);
+            std::cout << "[diff_test] shrunk to: " << (why.empty() ? "(no longer reproduces)" : why) << "\n";
+            printCase(std::cout, f);
+            return 1;
+        }
+        played += b.games.size();
+    }
+    std::cout << "[diff_test] OK: " << played << " games, reference " << reference
+              << ", candidate " << candidate << " (batch_size=" << batchSize
+              << ", decision_threads=" << decisionThreads << ", max_tanks=" << maxTanks
+              << ", seed=" << seed << ")\n";
+    if (reference == candidate)
+        std::cout << "[diff_test] note: the candidate was compared with itself (run() against"
+                  << " runBatch()); this checks batching, threads and engines, not the game rules\n";
+    return 0;
+}
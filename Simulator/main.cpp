@@ -8,17 +8,48 @@
 #include <string>
 #include <mutex>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <optional>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <deque>
+#include <list>
 #include <dlfcn.h>
+#include <sys/stat.h>
 #include <stdexcept>
+#include <thread>
+#include <atomic>
 
 #include "ArgParser.hpp"
 #include "AlgorithmRegistrar.h"
 #include "GameManagerRegistrar.h"
 #include "ThreadPool.hpp"
+#include "ProgressReporter.hpp"
+#include "Ratings.hpp"
+#include "CpuTopology.hpp"
+#include "Hashing.hpp"
+#include "ResultJournal.hpp"
+#include "ResultCache.hpp"
+#include "CompetitionReport.hpp"
+#include "Sharding.hpp"
+#include "TiledMap.hpp"
+#include "Daemon.hpp"
+#include "AllocTracker.hpp"
+#include "Profiler.hpp"
 #include "SatelliteView.h"
 #include "GameResult.h"
+#include "StaticMapAnalysis.h"
+#include "BatchGameManager.h"
+#ifdef SIM_STATIC_PLUGINS
+#include "StaticPluginTable.h"
+#endif
 
 namespace fs = std::filesystem;
+using UserCommon_315634022::StaticMapAnalysis;
+using UserCommon_315634022::StaticMapAnalysisProvider;
 
 //------------------------------------------------------------------------------
 // MapLoader: parse your assignment‐style map file
@@ -29,7 +60,132 @@ struct MapData {
     size_t maxSteps, numShells;
 };
 
+class MapView : public SatelliteView, public StaticMapAnalysisProvider {
+public:
+    MapView(std::vector<std::string>&& rows)
+      : rows_(std::move(rows)),
+        width_(rows_.empty() ? 0 : rows_[0].size()),
+        height_(rows_.size()),
+        analysis_(std::make_shared<LazyAnalysis>()) {}
+    char getObjectAt(size_t x, size_t y) const override {
+        return (y<height_ && x<width_) ? rows_[y][x] : ' ';
+    }
+    // Computed on the first call, once for this map and all its replicas
+    const StaticMapAnalysis* staticAnalysis() const override {
+        std::call_once(analysis_->once, [this] {
+            analysis_->value = StaticMapAnalysis::compute(*this, width_, height_);
+        });
+        return analysis_->value.get();
+    }
+    size_t width()  const { return width_;  }
+    size_t height() const { return height_; }
+
+    // Deep copy of the grid, allocated by the calling thread; the analysis
+    // is read-only and stays shared with the original
+    std::shared_ptr<MapView> replicate() const {
+        return std::make_shared<MapView>(*this);
+    }
+private:
+    struct LazyAnalysis {
+        std::once_flag                           once;
+        std::shared_ptr<const StaticMapAnalysis> value;
+    };
+
+    std::vector<std::string> rows_;
+    size_t width_, height_;
+    std::shared_ptr<LazyAnalysis> analysis_;
+};
+
+//------------------------------------------------------------------------------
+// Loaded maps by index, plus node-local copies for a pinned pool spanning
+// several NUMA nodes: each node's copy is made by a thread pinned to one of
+// its CPUs, so first touch places its pages there, and a worker reads the
+// copy of the node it is pinned on. Unpinned threads, and a pool on one node,
+// use the originals. set()/release() of different maps may run concurrently.
+//------------------------------------------------------------------------------
+class NodeLocalMaps {
+public:
+    NodeLocalMaps(const CpuTopology& topo, const std::vector<int>& pinnedCpus, size_t numMaps)
+      : topo_(topo), maps_(numMaps), copies_(numMaps) {
+        for (int cpu : pinnedCpus) {
+            int node = topo.nodeOf(cpu);
+            bool seen = false;
+            for (auto& nc : nodeCpu_) seen = seen || nc.first == node;
+            if (!seen) nodeCpu_.emplace_back(node, cpu);
+        }
+        if (nodeCpu_.size() < 2) nodeCpu_.clear();
+    }
+
+    void set(size_t mi, std::shared_ptr<SatelliteView> view) {
+        auto* mv = dynamic_cast<const MapView*>(view.get());
+        copies_[mi].assign(nodeCpu_.size(), view);
+        for (size_t k = 0; mv && k < nodeCpu_.size(); ++k) {
+            std::thread([&, k] {
+                pinCurrentThread(nodeCpu_[k].second);
+                copies_[mi][k] = mv->replicate();
+            }).join();
+        }
+        maps_[mi] = std::move(view);
+    }
+
+    void release(size_t mi) {
+        maps_[mi].reset();
+        copies_[mi].clear();
+    }
+
+    SatelliteView& forCurrentThread(size_t mi) const {
+        int cpu = ThreadPool::currentCpu();
+        if (cpu >= 0) {
+            int node = topo_.nodeOf(cpu);
+            for (size_t k = 0; k < nodeCpu_.size(); ++k)
+                if (nodeCpu_[k].first == node) return *copies_[mi][k];
+        }
+        return *maps_[mi];
+    }
+
+private:
+    const CpuTopology&                                        topo_;
+    std::vector<std::pair<int, int>>                          nodeCpu_;   // (node, a pinned CPU on it)
+    std::vector<std::shared_ptr<SatelliteView>>               maps_;
+    std::vector<std::vector<std::shared_ptr<SatelliteView>>>  copies_;    // [map][nodeCpu_ index]
+};
+
+// Rows/Cols/MaxSteps/NumShells of a map file, read without the grid: stops
+// as soon as all four are seen. The grid is checked by loadMapWithParams.
+struct MapHeader {
+    size_t rows = 0, cols = 0, maxSteps = 0, numShells = 0;
+};
+
+static MapHeader readMapHeader(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open map file: " + path);
+    }
+    MapHeader hd;
+    bool seen[4] = {false, false, false, false};
+    std::string line;
+    while (!(seen[0] && seen[1] && seen[2] && seen[3]) && std::getline(in, line)) {
+        auto value = [&] { return std::stoul(line.substr(line.find('=') + 1)); };
+        if      (line.rfind("Rows",      0) == 0) { hd.rows      = value(); seen[0] = true; }
+        else if (line.rfind("Cols",      0) == 0) { hd.cols      = value(); seen[1] = true; }
+        else if (line.rfind("MaxSteps",  0) == 0) { hd.maxSteps  = value(); seen[2] = true; }
+        else if (line.rfind("NumShells", 0) == 0) { hd.numShells = value(); seen[3] = true; }
+    }
+    if (hd.rows==0 || hd.cols==0)
+        throw std::runtime_error("Missing Rows or Cols in map header");
+    return hd;
+}
+
+// Maps of at least this many cells are compiled into tiles (TiledMapView)
+// rather than held as rows of text, and get no static analysis.
+static constexpr size_t kTiledMapCells = size_t(1) << 22;
+
 static MapData loadMapWithParams(const std::string& path) {
+    const MapHeader hd = readMapHeader(path);
+    std::unique_ptr<TiledMapBuilder> tiles;
+    if (hd.rows * hd.cols >= kTiledMapCells)
+        tiles = std::make_unique<TiledMapBuilder>(hd.rows, hd.cols);
+
     std::ifstream in(path);
     if (!in.is_open()) {
         throw std::runtime_error("Failed to open map file: " + path);
@@ -58,10 +214,22 @@ static MapData loadMapWithParams(const std::string& path) {
                     break;
                 }
             }
-            if (isGrid) gridLines.push_back(line);
+            if (!isGrid)    continue;
+            if (tiles)      tiles->addRow(line);
+            else            gridLines.push_back(line);
         }
     }
 
+    MapData md;
+    md.rows      = rows;
+    md.cols      = cols;
+    md.maxSteps  = maxSteps;
+    md.numShells = numShells;
+    if (tiles) {
+        md.view = tiles->finish();
+        return md;
+    }
+
     if (rows==0 || cols==0)
         throw std::runtime_error("Missing Rows or Cols in map header");
     if (gridLines.size() != rows) {
@@ -78,29 +246,8 @@ static MapData loadMapWithParams(const std::string& path) {
         }
     }
 
-    // Build SatelliteView:
-    class MapView : public SatelliteView {
-    public:
-        MapView(std::vector<std::string>&& rows)
-          : rows_(std::move(rows)),
-            width_(rows_.empty() ? 0 : rows_[0].size()),
-            height_(rows_.size()) {}
-        char getObjectAt(size_t x, size_t y) const override {
-            return (y<height_ && x<width_) ? rows_[y][x] : ' ';
-        }
-        size_t width()  const { return width_;  }
-        size_t height() const { return height_; }
-    private:
-        std::vector<std::string> rows_;
-        size_t width_, height_;
-    };
-
-    MapData md;
-    md.rows      = rows;
-    md.cols      = cols;
-    md.maxSteps  = maxSteps;
-    md.numShells = numShells;
-    md.view      = std::make_unique<MapView>(std::move(gridLines));
+    // Build SatelliteView (+ its static analysis, shared by every game on it):
+    md.view = std::make_unique<MapView>(std::move(gridLines));
     return md;
 }
 
@@ -112,43 +259,350 @@ static std::string stripSo(const std::string& path) {
     return fname;
 }
 
+// Handle for a plugin that is linked into this binary (monolithic build).
+static char linkedInTag;
+static void* const kLinkedIn = &linkedInTag;
+
+// Make the plugin at `path` register into the registrar's last entry: normally
+// by dlopen(); in the monolithic build (make static) from the static plugin
+// table when the .so name was linked in. Returns null on failure.
+static void* openAlgorithmPlugin(const std::string& path) {
+#ifdef SIM_STATIC_PLUGINS
+    auto p = UserCommon_315634022::findStaticPlugin(stripSo(path));
+    if (p.player || p.tankAlgorithm) {
+        auto& reg = AlgorithmRegistrar::get();
+        if (p.player)        reg.addPlayerFactoryToLastEntry(p.player);
+        if (p.tankAlgorithm) reg.addTankAlgorithmFactoryToLastEntry(p.tankAlgorithm);
+        return kLinkedIn;
+    }
+#endif
+    return dlopen(path.c_str(), RTLD_NOW);
+}
+
+static void* openGameManagerPlugin(const std::string& path) {
+#ifdef SIM_STATIC_PLUGINS
+    auto p = UserCommon_315634022::findStaticPlugin(stripSo(path));
+    if (p.gameManager) {
+        GameManagerRegistrar::get().addGameManagerFactoryToLastEntry(p.gameManager);
+        return kLinkedIn;
+    }
+#endif
+    return dlopen(path.c_str(), RTLD_NOW);
+}
+
+static void closePlugin(void* h) {
+    if (h && h != kLinkedIn) dlclose(h);
+}
+
+static std::string dlError() {
+    const char* e = dlerror();
+    return e ? e : "unknown error";
+}
+
+// Copies of registrar entries: a run keeps its own, so later loads and
+// unloads never disturb games in flight.
+using AlgorithmEntry   = std::decay_t<decltype(*AlgorithmRegistrar::get().begin())>;
+using GameManagerEntry = std::decay_t<decltype(*GameManagerRegistrar::get().begin())>;
+
+//------------------------------------------------------------------------------
+// Plugins registered in this process, by path. Each .so is opened once however
+// many runs use it (a second dlopen() of a loaded file returns the same handle
+// and registers nothing). Failures are remembered as well. A registration is
+// moved out of the registrar into the cache, so a plugin can be unloaded
+// again (forget()) once no run pins it. Thread-safe.
+//------------------------------------------------------------------------------
+class PluginCache {
+public:
+    // Throw std::runtime_error saying why the plugin did not load or register.
+    // With `pin`, it is set to keep the plugin mapped for as long as it is
+    // held, forget() or not; the entry's factories are only valid until then.
+    AlgorithmEntry algorithm(const std::string& path, std::shared_ptr<const void>* pin = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& loaded = load(algos_, AlgorithmRegistrar::get(), path, "Algo", [&](const std::string& name) {
+            AlgorithmRegistrar::get().createAlgorithmFactoryEntry(name);
+            return openAlgorithmPlugin(path);
+        });
+        if (pin) *pin = loaded;
+        return *loaded->entry;
+    }
+
+    GameManagerEntry gameManager(const std::string& path, std::shared_ptr<const void>* pin = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& loaded = load(gms_, GameManagerRegistrar::get(), path, "GM", [&](const std::string& name) {
+            GameManagerRegistrar::get().createGameManagerEntry(name);
+            return openGameManagerPlugin(path);
+        });
+        if (pin) *pin = loaded;
+        return *loaded->entry;
+    }
+
+    // `path` is superseded: the cache lets go of its plugin, which is closed
+    // when the last pin goes, and refuses to load it again.
+    void forget(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string k = key(path);
+        algos_.erase(k);
+        gms_.erase(k);
+        errors_.erase(k);
+        hashes_.erase(k);
+        retired_.insert(k);
+    }
+
+    // Content hash of a loaded plugin for the result cache (a linked-in one
+    // is part of this binary); 0, so never cached, if it cannot be read.
+    std::uint64_t hash(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string k = key(path);
+        auto [it, fresh] = hashes_.try_emplace(k, 0);
+        if (fresh) {
+            auto a = algos_.find(k);
+            auto g = gms_.find(k);
+            bool linkedIn = (a != algos_.end() && a->second && a->second->handle == kLinkedIn) ||
+                            (g != gms_.end()   && g->second && g->second->handle == kLinkedIn);
+            try { it->second = hashFile(linkedIn ? "/proc/self/exe" : path); }
+            catch (const std::exception&) {}
+        }
+        return it->second;
+    }
+
+private:
+    // A registered plugin; its factories (code in the .so) go before dlclose()
+    template <class Entry>
+    struct Loaded {
+        Loaded(const Entry& e, void* h) : entry(e), handle(h) {}
+        ~Loaded() {
+            entry.reset();
+            closePlugin(handle);
+        }
+        std::optional<Entry> entry;
+        void*                handle;
+    };
+    template <class Entry>
+    using Slot = std::shared_ptr<Loaded<Entry>>;   // null: the plugin failed, see errors_
+
+    template <class Entry, class Registrar, class Open>
+    const Slot<Entry>& load(std::unordered_map<std::string, Slot<Entry>>& slots, Registrar& reg,
+                              const std::string& path, const char* kind, Open open) {
+        const std::string k = key(path);
+        const std::string name = stripSo(path);
+        if (retired_.count(k))
+            throw std::runtime_error(std::string(kind) + " '" + name + "' was replaced, try again");
+        auto [it, fresh] = slots.try_emplace(k);
+        if (fresh) {
+            void* handle = open(name);
+            if (!handle) {
+                errors_[k] = "dlopen " + std::string(kind) + " '" + name + "' failed: " + dlError();
+                reg.removeLast();
+            } else {
+                try {
+                    reg.validateLastRegistration();
+                    it->second = std::make_shared<Loaded<Entry>>(*(reg.end() - 1), handle);
+                    reg.removeLast();
+                } catch (...) {
+                    errors_[k] = std::string(kind) + " registration failed for '" + name + "'";
+                    reg.removeLast();
+                    closePlugin(handle);
+                }
+            }
+        }
+        if (!it->second) throw std::runtime_error(errors_[k]);
+        return it->second;
+    }
+
+    static std::string key(const std::string& path) {
+        std::error_code ec;
+        auto canon = fs::weakly_canonical(path, ec);
+        return ec ? path : canon.string();
+    }
+
+    std::mutex                                                      mutex_;
+    std::unordered_map<std::string, Slot<AlgorithmEntry>>           algos_;
+    std::unordered_map<std::string, Slot<GameManagerEntry>>         gms_;
+    std::unordered_map<std::string, std::string>                    errors_;
+    std::unordered_map<std::string, std::uint64_t>                  hashes_;
+    std::unordered_set<std::string>                                 retired_;
+};
+
+//------------------------------------------------------------------------------
+// Parsed maps by path, for runs that share them (the jobs of a batch, the
+// games of the daemon): each is parsed once, by the first run to ask, and
+// again if the file has changed since. A map is kept for later runs, or, if
+// it was only asked for unkept (a competition bounding its resident maps),
+// for as long as someone holds it. With a keep limit (the daemon), only that
+// many of the most recently kept maps are. Thread-safe.
+//------------------------------------------------------------------------------
+struct LoadedMap {
+    std::shared_ptr<SatelliteView> view;
+    size_t rows, cols;
+    size_t maxSteps, numShells;
+};
+
+class MapCache {
+public:
+    // At most `n` maps kept (0: no limit), the least recently asked for let
+    // go first.
+    void setKeepLimit(size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        keepLimit_ = n;
+        trimKept();
+    }
+
+    // Throws what loadMapWithParams throws; a failed map is retried next time.
+    std::shared_ptr<const LoadedMap> get(const std::string& path, bool keep = true) {
+        std::shared_ptr<Slot> slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& s = slots_[path];
+            if (!s) s = std::make_shared<Slot>();
+            slot = s;
+        }
+        // parse outside the cache lock: other maps stay available meanwhile
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        const Stamp now = stamp(path);
+        std::shared_ptr<const LoadedMap> map = slot->map.lock();
+        const bool parsed = !map || !(slot->stamp == now);
+        if (parsed) {
+            MapData md = loadMapWithParams(path);
+            map = std::make_shared<const LoadedMap>(LoadedMap{
+                std::shared_ptr<SatelliteView>(std::move(md.view)),
+                md.rows, md.cols, md.maxSteps, md.numShells});
+            slot->map = map;
+            slot->stamp = now;
+        }
+        if (keep || parsed) {
+            // (slot lock, then cache lock: never the other way round)
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(kept_.begin(), kept_.end(),
+                                   [&](const Kept& k) { return k.path == path; });
+            if (it != kept_.end()) kept_.erase(it);   // an older parse, or moving to the front
+            if (keep) {
+                kept_.push_front(Kept{path, map});
+                trimKept();
+            }
+        }
+        return map;
+    }
+
+private:
+    // What tells a rewritten file from the one parsed
+    struct Stamp {
+        fs::file_time_type mtime{};
+        std::uintmax_t     size = 0;
+        bool operator==(const Stamp& o) const { return mtime == o.mtime && size == o.size; }
+    };
+    static Stamp stamp(const std::string& path) {
+        std::error_code ec;
+        Stamp st;
+        st.mtime = fs::last_write_time(path, ec);
+        st.size  = fs::file_size(path, ec);
+        return st;
+    }
+
+    struct Slot {
+        std::mutex                       mutex;
+        std::weak_ptr<const LoadedMap>   map;
+        Stamp                            stamp;
+    };
+    struct Kept {
+        std::string                      path;
+        std::shared_ptr<const LoadedMap> map;
+    };
+
+    // caller holds mutex_
+    void trimKept() {
+        while (keepLimit_ > 0 && kept_.size() > keepLimit_) kept_.pop_back();
+    }
+
+    std::mutex                                             mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Slot>> slots_;
+    std::list<Kept>                                        kept_;   // most recently asked for first
+    size_t                                                 keepLimit_ = 0;
+};
+
+//------------------------------------------------------------------------------
+// What the runs of one process share: plugins, parsed maps, result caches and
+// the worker pool. A plain invocation is a session of one run; --batch= runs
+// every job of its manifest in one.
+//------------------------------------------------------------------------------
+class Session {
+public:
+    Session(const Config& cfg, const CpuTopology& topo)
+      : topo_(topo),
+        poolCpus_(cfg.pinThreads ? topo.pinOrder(size_t(cfg.numThreads)) : std::vector<int>{}),
+        pool_(size_t(cfg.numThreads), poolCpus_) {}
+
+    const CpuTopology&      topo()     const { return topo_; }
+    const std::vector<int>& poolCpus() const { return poolCpus_; }
+    PluginCache&            plugins()        { return plugins_; }
+    MapCache&               maps()           { return maps_; }
+    ThreadPool&             pool()           { return pool_; }
+
+    // The result_cache= file at `path`, opened once (null for ""). Throws if
+    // it cannot be opened.
+    ResultCache* resultCache(const std::string& path) {
+        if (path.empty()) return nullptr;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& c = caches_[path];
+        if (!c) c = std::make_unique<ResultCache>(path);
+        return c.get();
+    }
+
+private:
+    const CpuTopology&     topo_;
+    const std::vector<int> poolCpus_;
+    PluginCache            plugins_;
+    MapCache               maps_;
+    std::mutex             mutex_;
+    std::unordered_map<std::string, std::unique_ptr<ResultCache>> caches_;
+    ThreadPool             pool_;   // last: its workers stop before the rest goes
+};
+
+// The game parameters part of a result cache key.
+static std::string cacheParams(size_t maxSteps, size_t numShells) {
+    return "max_steps=" + std::to_string(maxSteps) + ";num_shells=" + std::to_string(numShells);
+}
+
+// FNV-1a fingerprint of a final board: one bulk pass over rows×cols,
+// taken by the worker while the GM (which owns the view) is still alive.
+static std::uint64_t hashGameState(const SatelliteView* view, size_t rows, size_t cols) {
+    std::uint64_t h = kFnvOffset;
+    if (!view) return h;
+    for (size_t y = 0; y < rows; ++y) {
+        for (size_t x = 0; x < cols; ++x) {
+            char c = view->getObjectAt(x, y);
+            h = fnv1a(&c, 1, h);
+        }
+    }
+    return h;
+}
+
 // -----------------------------
 // Comparative mode
 // -----------------------------
-static int runComparative(const Config& cfg) {
+static int runComparative(const Config& cfg, Session& session, std::ostream& out) {
     // 1) Load map + params
-    MapData md;
+    std::shared_ptr<const LoadedMap> map;
     try {
-        md = loadMapWithParams(cfg.game_map);
+        map = session.maps().get(cfg.game_map);
     } catch (const std::exception& ex) {
         std::cerr << "Error loading map: " << ex.what() << "\n";
         return 1;
     }
-    SatelliteView& realMap = *md.view;
+    const LoadedMap& md = *map;
+    NodeLocalMaps localMaps(session.topo(), session.poolCpus(), 1);
+    localMaps.set(0, md.view);
 
     // 2) Load Algorithms
-    auto& algoReg = AlgorithmRegistrar::get();
-    std::vector<void*> algoHandles;
-    for (auto const& algPath : {cfg.algorithm1, cfg.algorithm2}) {
-        std::string name = stripSo(algPath);
-        algoReg.createAlgorithmFactoryEntry(name);
-        void* h = dlopen(algPath.c_str(), RTLD_NOW);
-        if (!h) {
-            std::cerr << "Error: dlopen Algo '" << name << "' failed: " << dlerror() << "\n";
-            return 1;
-        }
-        try { algoReg.validateLastRegistration(); }
-        catch (...) {
-            std::cerr << "Error: Algo registration failed for '" << name << "'\n";
-            algoReg.removeLast();
-            dlclose(h);
-            return 1;
-        }
-        algoHandles.push_back(h);
+    std::vector<AlgorithmEntry> algos;
+    try {
+        for (auto const& algPath : {cfg.algorithm1, cfg.algorithm2})
+            algos.push_back(session.plugins().algorithm(algPath));
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
     }
 
     // 3) Load GameManagers
-    auto& gmReg = GameManagerRegistrar::get();
     std::vector<std::string> gmPaths;
     for (auto& e : fs::directory_iterator(cfg.game_managers_folder))
         if (e.path().extension() == ".so")
@@ -158,42 +612,72 @@ static int runComparative(const Config& cfg) {
         return 1;
     }
 
-    std::vector<void*> gmHandles;
-    for (auto const& gmPath : gmPaths) {
-        std::string name = stripSo(gmPath);
-        gmReg.createGameManagerEntry(name);
-        void* h = dlopen(gmPath.c_str(), RTLD_NOW);
-        if (!h) {
-            std::cerr << "Error: dlopen GM '" << name << "' failed: " << dlerror() << "\n";
-            return 1;
-        }
-        try { gmReg.validateLastRegistration(); }
-        catch (...) {
-            std::cerr << "Error: GM registration failed for '" << name << "'\n";
-            gmReg.removeLast();
-            dlclose(h);
-            return 1;
-        }
-        gmHandles.push_back(h);
+    std::vector<GameManagerEntry> gms;
+    try {
+        for (auto const& gmPath : gmPaths)
+            gms.push_back(session.plugins().gameManager(gmPath));
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
     }
 
-    // 4) Dispatch tasks
-    ThreadPool pool(cfg.numThreads);
+    // 4) Result cache: a GM whose inputs all match a stored game is not run.
+    // --verbose games are always played, since their logs are the point.
+    ResultCache* cache = nullptr;
+    CacheKey baseKey;
+    std::vector<std::uint64_t> gmHashes(gmPaths.size(), 0);
+    try {
+        cache = session.resultCache(cfg.resultCache);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+    if (cache) {
+        baseKey.a1     = session.plugins().hash(cfg.algorithm1);
+        baseKey.a2     = session.plugins().hash(cfg.algorithm2);
+        baseKey.params = cacheParams(md.maxSteps, md.numShells);
+        try { baseKey.map = hashFile(cfg.game_map); }
+        catch (const std::exception&) {}
+        for (size_t gi = 0; gi < gmPaths.size(); ++gi)
+            gmHashes[gi] = session.plugins().hash(gmPaths[gi]);
+    }
+    const bool useCached = cache && !cfg.rerun && !cfg.verbose;
+    size_t cachedGames = 0;
+
+    // 5) Dispatch tasks
+    ThreadPool& pool = session.pool();
     std::mutex mtx;
     struct Entry {
         std::string gm, a1, a2;
         GameResult res;
-        Entry(std::string g, std::string x, std::string y, GameResult r)
-          : gm(std::move(g)), a1(std::move(x)), a2(std::move(y)), res(std::move(r)) {}
+        std::uint64_t stateHash;
+        Entry(std::string g, std::string x, std::string y, GameResult r, std::uint64_t h)
+          : gm(std::move(g)), a1(std::move(x)), a2(std::move(y)), res(std::move(r)), stateHash(h) {}
     };
     std::vector<Entry> results;
+    std::vector<ThreadPool::TaskHandle> runs(gmPaths.size());
 
     for (size_t gi = 0; gi < gmPaths.size(); ++gi) {
-        auto& gmEntry = *(gmReg.begin() + gi);
-        auto& A = *(algoReg.begin() + 0);
-        auto& B = *(algoReg.begin() + 1);
+        auto& gmEntry = gms[gi];
+        auto& A = algos[0];
+        auto& B = algos[1];
+
+        runs[gi] = pool.enqueue([&, gi] {
+            CacheKey key = baseKey;
+            key.gm = gmHashes[gi];
+            CachedResult cached;
+            if (useCached && cache->find(key, cached)) {
+                GameResult gr{};
+                gr.winner = cached.winner;
+                gr.reason = static_cast<GameResult::Reason>(cached.reason);
+                gr.rounds = cached.rounds;
+                std::lock_guard<std::mutex> lock(mtx);
+                results.emplace_back(stripSo(gmPaths[gi]), stripSo(cfg.algorithm1),
+                                     stripSo(cfg.algorithm2), std::move(gr), cached.stateHash);
+                ++cachedGames;
+                return;
+            }
 
-        pool.enqueue([&, gi] {
             auto gm = gmEntry.factory(cfg.verbose);
             auto p1 = A.createPlayer(0, 0, 0, md.maxSteps, md.numShells);
             auto a1 = A.createTankAlgorithm(0, 0);
@@ -202,7 +686,7 @@ static int runComparative(const Config& cfg) {
 
             GameResult gr = gm->run(
                 md.cols, md.rows,
-                realMap,
+                localMaps.forCurrentThread(0),
                 cfg.game_map,
                 md.maxSteps, md.numShells,
                 *p1, stripSo(cfg.algorithm1),
@@ -210,37 +694,87 @@ static int runComparative(const Config& cfg) {
                 [&](int pi,int ti){ return A.createTankAlgorithm(pi,ti); },
                 [&](int pi,int ti){ return B.createTankAlgorithm(pi,ti); }
             );
+            std::uint64_t h = hashGameState(gr.gameState.get(), md.rows, md.cols);
+            gr.gameState.reset(); // views into *gm, which dies with this task
+            if (cache)
+                cache->store(key, CachedResult{gr.winner, static_cast<int>(gr.reason), gr.rounds, h});
 
             std::lock_guard<std::mutex> lock(mtx);
             results.emplace_back(
                 stripSo(gmPaths[gi]),
                 stripSo(cfg.algorithm1),
                 stripSo(cfg.algorithm2),
-                std::move(gr)
+                std::move(gr),
+                h
             );
         });
     }
-    pool.shutdown();
+    for (size_t gi = 0; gi < runs.size(); ++gi) {
+        try { runs[gi].wait(); }
+        catch (const std::exception& ex) {
+            std::cerr << "Warning: GM '" << stripSo(gmPaths[gi]) << "' failed: " << ex.what() << "\n";
+        }
+    }
+    if (cache) cache->flush();
 
-    // 5) Report & cleanup
-    std::cout << "[Simulator] Comparative Results:\n";
+    // 6) Group GMs that agree on (winner, reason, rounds, final state)
+    struct GroupKey {
+        int winner, reason;
+        size_t rounds;
+        std::uint64_t stateHash;
+        bool operator==(const GroupKey& o) const {
+            return winner == o.winner && reason == o.reason &&
+                   rounds == o.rounds && stateHash == o.stateHash;
+        }
+    };
+    struct GroupKeyHash {
+        size_t operator()(const GroupKey& k) const {
+            std::uint64_t h = k.stateHash;
+            h ^= std::uint64_t(k.winner) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            h ^= std::uint64_t(k.reason) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            h ^= std::uint64_t(k.rounds) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            return size_t(h);
+        }
+    };
+    std::unordered_map<GroupKey, size_t, GroupKeyHash> groupOf;
+    std::vector<std::pair<GroupKey, std::vector<std::string>>> groups;
     for (auto& e : results) {
-        std::cout << "  GM=" << e.gm
-                  << "  A1=" << e.a1
-                  << "  A2=" << e.a2
-                  << " => winner="  << e.res.winner
-                  << "  reason="  << static_cast<int>(e.res.reason)
-                  << "  rounds=" << e.res.rounds << "\n";
-    }
-    // for (auto h : gmHandles)   dlclose(h);
-    // for (auto h : algoHandles) dlclose(h);
+        GroupKey k{e.res.winner, static_cast<int>(e.res.reason), e.res.rounds, e.stateHash};
+        auto [it, fresh] = groupOf.try_emplace(k, groups.size());
+        if (fresh) groups.emplace_back(k, std::vector<std::string>{});
+        groups[it->second].second.push_back(e.gm);
+    }
+    // largest group first; ties and members by name so the report is stable
+    for (auto& g : groups) std::sort(g.second.begin(), g.second.end());
+    std::sort(groups.begin(), groups.end(), [](auto const& a, auto const& b) {
+        if (a.second.size() != b.second.size()) return a.second.size() > b.second.size();
+        return a.second.front() < b.second.front();
+    });
+
+    // 7) Report & cleanup
+    out << "[Simulator] Comparative Results: A1=" << stripSo(cfg.algorithm1)
+              << "  A2=" << stripSo(cfg.algorithm2)
+              << "  (" << results.size() << " GMs, " << groups.size() << " groups";
+    if (cachedGames > 0) out << ", " << cachedGames << " from result cache";
+    out << ")\n";
+    for (size_t g = 0; g < groups.size(); ++g) {
+        auto const& k = groups[g].first;
+        out << "  group " << (g + 1)
+                  << " => winner=" << k.winner
+                  << "  reason=" << k.reason
+                  << "  rounds=" << k.rounds
+                  << "  state=" << toHex(k.stateHash)
+                  << "  (" << groups[g].second.size() << " GMs)\n";
+        for (auto const& name : groups[g].second)
+            out << "    GM=" << name << "\n";
+    }
     return 0;
 }
 
 // -----------------------------
 // Competition mode
 // -----------------------------
-static int runCompetition(const Config& cfg) {
+static int runCompetition(const Config& cfg, Session& session, std::ostream& out) {
     // 1) Gather maps
     std::vector<std::string> maps;
     for (auto& e : fs::directory_iterator(cfg.game_maps_folder))
@@ -250,148 +784,705 @@ static int runCompetition(const Config& cfg) {
         std::cerr << "Error: no files in game_maps_folder\n";
         return 1;
     }
+    // canonical order: every process (and every shard) sees the same matrix
+    std::sort(maps.begin(), maps.end());
 
     // 2) Load GM
-    auto& gmReg = GameManagerRegistrar::get();
     std::string gmName = stripSo(cfg.game_manager);
-    gmReg.createGameManagerEntry(gmName);
-    void* gmH = dlopen(cfg.game_manager.c_str(), RTLD_NOW);
-    if (!gmH) {
-        std::cerr << "Error: dlopen GM failed: " << dlerror() << "\n";
-        return 1;
-    }
-    try { gmReg.validateLastRegistration(); }
-    catch (...) {
-        std::cerr << "Error: GM registration failed for '" << gmName << "'\n";
-        gmReg.removeLast();
-        dlclose(gmH);
+    std::unique_ptr<GameManagerEntry> gmPlugin;
+    try {
+        gmPlugin = std::make_unique<GameManagerEntry>(session.plugins().gameManager(cfg.game_manager));
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
         return 1;
     }
 
     // 3) Load Algos
-    auto& algoReg = AlgorithmRegistrar::get();
-    std::vector<void*>    algoHandles;
+    std::vector<AlgorithmEntry> algos;
     std::vector<std::string> algoPaths;
-    for (auto& e : fs::directory_iterator(cfg.algorithms_folder)) {
-        if (e.path().extension() == ".so") {
-            std::string path = e.path().string();
-            algoReg.createAlgorithmFactoryEntry(stripSo(path));
-            void* h = dlopen(path.c_str(), RTLD_NOW);
-            if (!h) {
-                std::cerr << "Warning: dlopen Algo '" << path << "' failed\n";
-                algoReg.removeLast();
-                continue;
-            }
-            try { algoReg.validateLastRegistration(); }
-            catch (...) {
-                std::cerr << "Warning: Algo registration failed for '" << path << "'\n";
-                algoReg.removeLast();
-                dlclose(h);
-                continue;
-            }
-            algoHandles.push_back(h);
+    std::vector<std::string> algoFiles;
+    for (auto& e : fs::directory_iterator(cfg.algorithms_folder))
+        if (e.path().extension() == ".so")
+            algoFiles.push_back(e.path().string());
+    std::sort(algoFiles.begin(), algoFiles.end());
+    for (auto const& path : algoFiles) {
+        try {
+            algos.push_back(session.plugins().algorithm(path));
             algoPaths.push_back(path);
+        } catch (const std::exception& ex) {
+            std::cerr << "Warning: " << ex.what() << "\n";
         }
     }
     if (algoPaths.size() < 2) {
         std::cerr << "Error: need at least 2 algorithms in folder\n";
-        dlclose(gmH);
         return 1;
     }
 
-    // 4) Preload maps into shared_ptrs so lambdas can capture safely
-    std::vector<std::shared_ptr<SatelliteView>> mapViews;
-    std::vector<size_t>                         mapRows, mapCols, mapMaxSteps, mapNumShells;
+    // 4) Read just the map headers: enough to size and shard the games; the
+    // grids are parsed later, on the pool
+    std::vector<std::string> mapFiles;
+    std::vector<MapHeader>   mapHeaders;
     for (auto const& mapFile : maps) {
         try {
-            MapData md = loadMapWithParams(mapFile);
-            mapViews.emplace_back(std::move(md.view));
-            mapCols .push_back(md.cols);
-            mapRows .push_back(md.rows);
-            mapMaxSteps.push_back(md.maxSteps);
-            mapNumShells.push_back(md.numShells);
+            mapHeaders.push_back(readMapHeader(mapFile));
+            mapFiles.push_back(mapFile);
         } catch (const std::exception& ex) {
             std::cerr << "Warning: skipping map '" << mapFile << "': " << ex.what() << "\n";
         }
     }
-    if (mapViews.empty()) {
+    if (mapFiles.empty()) {
         std::cerr << "Error: no valid maps to run\n";
-        dlclose(gmH);
         return 1;
     }
 
-    // 5) Dispatch tasks
-    ThreadPool pool(cfg.numThreads);
-    std::mutex mtx;
-    struct Entry {
-        std::string mapFile, a1, a2;
-        GameResult res;
-        Entry(std::string m, std::string x, std::string y, GameResult r)
-          : mapFile(std::move(m)), a1(std::move(x)), a2(std::move(y)), res(std::move(r)) {}
+    // 5) Journal: replay finished games from resume=, record new ones
+    std::unordered_map<std::string, JournalRecord> done;
+    if (!cfg.resume.empty()) {
+        for (auto& r : ResultJournal::load(cfg.resume)) {
+            std::string key = journalKey(r.mapHash, r.a1, r.a2, r.gm);
+            done.insert_or_assign(std::move(key), std::move(r));
+        }
+    }
+    std::unique_ptr<ResultJournal> journal;
+    ResultCache*                   cache = nullptr;
+    const std::string& journalPath = cfg.journal.empty() ? cfg.resume : cfg.journal;
+    try {
+        if (!journalPath.empty()) journal = std::make_unique<ResultJournal>(journalPath);
+        cache = session.resultCache(cfg.resultCache);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+    // result cache: games whose GM, algorithms, map and parameters all match a
+    // stored game are not played (--verbose and --alloc_stats games always
+    // are, for their logs and counters)
+    std::uint64_t gmHash = 0;
+    std::vector<std::uint64_t> algoHashes(algoPaths.size(), 0);
+    if (cache) {
+        gmHash = session.plugins().hash(cfg.game_manager);
+        for (size_t a = 0; a < algoPaths.size(); ++a)
+            algoHashes[a] = session.plugins().hash(algoPaths[a]);
+    }
+    const bool useCached = cache && !cfg.rerun && !cfg.verbose && !cfg.allocStats;
+
+    // 6) Build the (map × algorithm-pair) matrix and pick this shard's slice.
+    // With pairing=swiss the matrix starts empty and grows a round at a time.
+    struct GameTask { size_t map, i, j; };
+    std::vector<GameTask>       tasks;
+    std::vector<CompetitionRow> results;
+    std::vector<char>           haveResult;
+    std::vector<AllocSummary>   allocs;   // --alloc_stats, per task
+    auto initRow = [&](size_t t) {
+        CompetitionRow& row = results[t];
+        row.task    = t;
+        row.mapFile = mapFiles[tasks[t].map];
+        row.a1      = stripSo(algoPaths[tasks[t].i]);
+        row.a2      = stripSo(algoPaths[tasks[t].j]);
     };
-    std::vector<Entry> results;
-    auto& gmEntry = *gmReg.begin();
-
-    for (size_t mi = 0; mi < mapViews.size(); ++mi) {
-        auto mapViewPtr = mapViews[mi];
-        size_t cols     = mapCols[mi],
-               rows     = mapRows[mi],
-               mSteps   = mapMaxSteps[mi],
-               nShells  = mapNumShells[mi];
-        const std::string mapFile = maps[mi];
-        SatelliteView& realMap = *mapViewPtr;
-
-        for (size_t i = 0; i + 1 < algoPaths.size(); ++i) {
-            for (size_t j = i + 1; j < algoPaths.size(); ++j) {
-                pool.enqueue([=,&realMap,&mtx,&results,&algoReg,&gmEntry]() {
-                    auto gm = gmEntry.factory(cfg.verbose);
-                    auto& A = *(algoReg.begin() + i);
-                    auto& B = *(algoReg.begin() + j);
-                    auto p1 = A.createPlayer(0,0,0,mSteps,nShells);
-                    auto a1 = A.createTankAlgorithm(0,0);
-                    auto p2 = B.createPlayer(1,0,0,mSteps,nShells);
-                    auto a2 = B.createTankAlgorithm(1,0);
-
-                    GameResult gr = gm->run(
-                        cols, rows,
-                        realMap,
-                        mapFile,
-                        mSteps, nShells,
-                        *p1, stripSo(algoPaths[i]),
-                        *p2, stripSo(algoPaths[j]),
-                        [&](int pi,int ti){ return A.createTankAlgorithm(pi,ti); },
-                        [&](int pi,int ti){ return B.createTankAlgorithm(pi,ti); }
-                    );
-
-                    std::lock_guard<std::mutex> lock(mtx);
-                    results.emplace_back(
-                        mapFile,
-                        stripSo(algoPaths[i]),
-                        stripSo(algoPaths[j]),
-                        std::move(gr)
-                    );
-                });
+    std::vector<size_t> round;   // the games to play next, in task order
+    if (!cfg.swissPairing) {
+        std::vector<double> costs;
+        for (size_t mi = 0; mi < mapFiles.size(); ++mi) {
+            const MapHeader& hd = mapHeaders[mi];
+            // a game costs roughly one board scan per tank per step
+            double cost = double(hd.rows) * double(hd.cols) * double(hd.maxSteps + 1);
+            for (size_t i = 0; i + 1 < algoPaths.size(); ++i) {
+                for (size_t j = i + 1; j < algoPaths.size(); ++j) {
+                    tasks.push_back({mi, i, j});
+                    costs.push_back(cost);
+                }
             }
         }
+        std::vector<size_t> shardOf = assignShards(costs, size_t(cfg.shardCount));
+        results.resize(tasks.size());
+        haveResult.assign(tasks.size(), 0);
+        allocs.resize(tasks.size());
+        for (size_t t = 0; t < tasks.size(); ++t) {
+            if (shardOf[t] != size_t(cfg.shardIndex)) continue;
+            initRow(t);
+            round.push_back(t);
+        }
     }
-    pool.shutdown();
+    const size_t numAlgos = algoPaths.size();
+    const size_t rounds  = !cfg.swissPairing ? 1
+                         : cfg.swissRounds > 0 ? size_t(cfg.swissRounds)
+                         : defaultSwissRounds(numAlgos);
 
-    // 6) Report & cleanup
-    std::cout << "[Simulator] Competition Results:\n";
-    for (auto& e : results) {
-        std::cout << "  map=" << e.mapFile
-                  << "  A1=" << e.a1
-                  << "  A2=" << e.a2
-                  << " => winner=" << e.res.winner
-                  << "  reason=" << static_cast<int>(e.res.reason)
-                  << "  rounds=" << e.res.rounds << "\n";
+    // 7) Pipeline per map on the pool: load (hash, resume lookup, parse) ->
+    // its pending games in batches of batch_size -> release. Loading a map
+    // waits for the release of the map max_resident_maps loads earlier, which
+    // caps how many parsed maps are held at once. A GM that implements
+    // BatchGameManager plays a batch in lockstep, any other plays its games
+    // one after another.
+    ThreadPool& pool = session.pool();
+    NodeLocalMaps localMaps(session.topo(), session.poolCpus(), mapFiles.size());
+    const size_t batchSize   = size_t(cfg.batchSize);
+    const size_t maxResident = cfg.maxResidentMaps > 0 ? size_t(cfg.maxResidentMaps)
+                                                       : 2 * size_t(cfg.numThreads);
+    std::vector<std::uint64_t>       mapHashes(mapFiles.size(), 0);
+    std::vector<std::vector<size_t>> pending(mapFiles.size());
+    std::vector<size_t>              resumedOn(mapFiles.size(), 0);
+    std::vector<size_t>              cachedOn(mapFiles.size(), 0);
+    std::vector<std::string>         mapErrors(mapFiles.size());
+    std::unique_ptr<ProgressReporter> progress;
+    if (cfg.progressSeconds > 0 || !cfg.metricsFile.empty()) {
+        size_t total = cfg.swissPairing ? rounds * (numAlgos / 2) * mapFiles.size() : round.size();
+        double every = cfg.progressSeconds > 0 ? cfg.progressSeconds : 10.0;
+        progress = std::make_unique<ProgressReporter>(
+            pool, total, std::chrono::milliseconds(long(every * 1000)),
+            cfg.progressSeconds > 0, cfg.metricsFile);
+    }
+    struct BatchRun { size_t map; std::string error; };
+    std::deque<BatchRun> batchRuns;                  // stable addresses for the tasks
+    auto& gmEntry = *gmPlugin;
+    auto cacheKey = [&](size_t t) {
+        const MapHeader& hd = mapHeaders[tasks[t].map];
+        return CacheKey{gmHash, algoHashes[tasks[t].i], algoHashes[tasks[t].j],
+                        mapHashes[tasks[t].map], cacheParams(hd.maxSteps, hd.numShells)};
+    };
+
+    // early_stop=: every pair's results so far. Once the sequential test
+    // decides a pair, its games not yet started are skipped; games already
+    // running still count, but the verdict stands.
+    const bool earlyStop = cfg.earlyStop > 0;
+    std::vector<PairRecord> pairRecords(earlyStop ? numAlgos * numAlgos : 0);
+    std::mutex pairMutex;
+    auto skipDecided = [&](size_t t) {
+        if (!earlyStop) return false;
+        std::lock_guard<std::mutex> lock(pairMutex);
+        PairRecord& p = pairRecords[tasks[t].i * numAlgos + tasks[t].j];
+        if (p.verdict == PairVerdict::Open) return false;
+        ++p.skipped;
+        return true;
+    };
+    auto recordGame = [&](size_t t, int winner) {
+        if (!earlyStop) return;
+        std::lock_guard<std::mutex> lock(pairMutex);
+        PairRecord& p = pairRecords[tasks[t].i * numAlgos + tasks[t].j];
+        if      (winner == 1) ++p.wins;
+        else if (winner == 2) ++p.losses;
+        else                  ++p.draws;
+        if (p.verdict == PairVerdict::Open)
+            p.verdict = sequentialTest(p.wins, p.losses, p.draws, cfg.earlyStop, &p.confidence);
+    };
+
+    // Swiss: every round pairs players of close rating that have met least
+    // often, and each pair plays on every map. The lower algorithm index is
+    // always player 1, so journal and cache entries are those of all-pairs runs.
+    std::vector<std::vector<unsigned>> met(numAlgos, std::vector<unsigned>(numAlgos, 0));
+    std::vector<unsigned>              byes(numAlgos, 0);
+    std::vector<Rating>                ratings(numAlgos);
+    auto rateFinished = [&] {
+        std::vector<RatedGame> games;
+        for (size_t t = 0; t < tasks.size(); ++t) {
+            if (!haveResult[t]) continue;
+            int w = results[t].winner;
+            games.push_back({tasks[t].i, tasks[t].j, w == 1 ? 1.0 : w == 2 ? 0.0 : 0.5});
+        }
+        ratings = rateGames(numAlgos, games);
+    };
+
+    for (size_t r = 0; r < rounds; ++r) {
+        if (cfg.swissPairing) {
+            std::vector<double> elo;
+            for (const Rating& rt : ratings) elo.push_back(rt.elo);
+            auto pairs = swissPairs(elo, met, byes);
+            round.clear();
+            for (size_t mi = 0; mi < mapFiles.size(); ++mi) {
+                for (auto& pr : pairs) {
+                    tasks.push_back({mi, pr.first, pr.second});
+                    results.emplace_back();
+                    haveResult.push_back(0);
+                    allocs.emplace_back();
+                    initRow(tasks.size() - 1);
+                    round.push_back(tasks.size() - 1);
+                }
+            }
+            for (auto& pr : pairs) { ++met[pr.first][pr.second]; ++met[pr.second][pr.first]; }
+        }
+        std::vector<std::vector<size_t>> mine(mapFiles.size());   // this shard's games per map
+        for (size_t t : round) mine[tasks[t].map].push_back(t);
+        for (auto& p : pending) p.clear();
+        std::vector<ThreadPool::TaskHandle> releases;   // in load order
+
+        for (size_t mi = 0; mi < mapFiles.size(); ++mi) {
+            if (mine[mi].empty()) continue;   // all in other shards: never parsed here
+            const std::string mapFile = mapFiles[mi];
+            const MapHeader   hd      = mapHeaders[mi];
+
+            std::vector<ThreadPool::TaskHandle> after;
+            if (releases.size() >= maxResident) after.push_back(releases[releases.size() - maxResident]);
+
+            // errors stay in mapErrors[mi]: a failed task would skip its
+            // dependents, and the next map's load depends on this release
+            auto loaded = pool.enqueue([&, mi, mapFile] {
+                size_t known = 0, skipped = 0;   // this round's games resumed or cached, or skipped
+                try {
+                    mapHashes[mi] = hashFile(mapFile);
+                    for (size_t t : mine[mi]) {
+                        CompetitionRow& row = results[t];
+                        auto it = done.find(journalKey(mapHashes[mi], row.a1, row.a2, gmName));
+                        CachedResult cached;
+                        if (it != done.end()) {
+                            row.winner = it->second.winner;
+                            row.reason = it->second.reason;
+                            row.rounds = it->second.rounds;
+                            ++resumedOn[mi];
+                        } else if (useCached && cache->find(cacheKey(t), cached)) {
+                            row.winner = cached.winner;
+                            row.reason = cached.reason;
+                            row.rounds = cached.rounds;
+                            ++cachedOn[mi];
+                            // journaled too, so a resume of this run needs no cache
+                            if (journal) {
+                                journal->append(JournalRecord{
+                                    mapHashes[mi], gmName, row.a1, row.a2,
+                                    row.winner, row.reason, row.rounds, mapFile
+                                });
+                            }
+                        } else if (skipDecided(t)) {
+                            ++skipped;
+                            continue;
+                        } else {
+                            pending[mi].push_back(t);
+                            continue;
+                        }
+                        haveResult[t] = 1;
+                        recordGame(t, row.winner);
+                        ++known;
+                    }
+                    if (progress) progress->gamesResumed(known);
+                    if (progress && skipped) progress->gamesSkipped(skipped);
+                    if (pending[mi].empty()) return;
+                    // through the session's cache, which shares the parse with any
+                    // job that uses the map while it is resident here; the view
+                    // holds the cache entry until release() drops it
+                    auto parsed = session.maps().get(mapFile, /*keep=*/false);
+                    localMaps.set(mi, std::shared_ptr<SatelliteView>(parsed, parsed->view.get()));
+                } catch (const std::exception& ex) {
+                    mapErrors[mi] = ex.what();
+                    pending[mi].clear();
+                    if (progress) progress->gamesFailed(mine[mi].size() - known - skipped);
+                }
+            }, after);
+
+            // the batch count is fixed before resume is known: trailing batches
+            // of a map with resumed games find nothing to play
+            std::vector<ThreadPool::TaskHandle> plays;
+            for (size_t first = 0; first < mine[mi].size(); first += batchSize) {
+                batchRuns.push_back({mi, ""});
+                BatchRun& run = batchRuns.back();
+
+                // each task writes only its own row slots, so no lock is needed
+                plays.push_back(loaded.then([=, &run, &pending, &localMaps, &tasks, &results, &haveResult,
+                                             &algos, &gmEntry, &journal, &mapHashes, &progress,
+                                             &cache, &cacheKey, &skipDecided, &recordGame, &allocs]() {
+                    if (first >= pending[mi].size()) return;
+                    std::vector<size_t> batch(
+                        pending[mi].begin() + first,
+                        pending[mi].begin() + std::min(first + batchSize, pending[mi].size()));
+                    const size_t queued = batch.size();
+                    batch.erase(std::remove_if(batch.begin(), batch.end(), skipDecided), batch.end());
+                    if (progress && batch.size() < queued) progress->gamesSkipped(queued - batch.size());
+                    if (batch.empty()) return;
+                    try {
+                        // --alloc_stats: declared first, as the proxies in players
+                        // and in the GM's tanks point into them
+                        std::vector<std::unique_ptr<GameAllocStats>> stats;
+                        std::vector<std::unique_ptr<Player>> players;
+                        std::vector<UserCommon_315634022::BatchGame> games;
+                        for (size_t t : batch) {
+                            auto& A = algos[tasks[t].i];
+                            auto& B = algos[tasks[t].j];
+                            GameAllocStats* st = nullptr;
+                            if (cfg.allocStats) {
+                                stats.push_back(std::make_unique<GameAllocStats>());
+                                st = stats.back().get();
+                            }
+                            players.push_back(trackPlayer(st, 0, [&] {
+                                return A.createPlayer(0,0,0,hd.maxSteps,hd.numShells); }));
+                            players.push_back(trackPlayer(st, 1, [&] {
+                                return B.createPlayer(1,0,0,hd.maxSteps,hd.numShells); }));
+                            games.push_back({
+                                players[players.size() - 2].get(), results[t].a1,
+                                players[players.size() - 1].get(), results[t].a2,
+                                trackTanks(st, 0, [&A](int pi,int ti){ return A.createTankAlgorithm(pi,ti); }),
+                                trackTanks(st, 1, [&B](int pi,int ti){ return B.createTankAlgorithm(pi,ti); })
+                            });
+                        }
+
+                        SatelliteView& realMap = localMaps.forCurrentThread(mi);
+                        auto gm = gmEntry.factory(cfg.verbose);
+                        // lockstep games can't be told apart: tracked games go one by one
+                        auto* batched = games.size() > 1 && !cfg.allocStats
+                            ? dynamic_cast<UserCommon_315634022::BatchGameManager*>(gm.get()) : nullptr;
+                        std::vector<GameResult> out;
+                        std::vector<std::uint64_t> states;   // final boards, for the result cache
+                        if (batched) {
+                            out = batched->runBatch(hd.cols, hd.rows, realMap, mapFile,
+                                                    hd.maxSteps, hd.numShells, games);
+                            if (cache)
+                                for (auto& gr : out)
+                                    states.push_back(hashGameState(gr.gameState.get(), hd.rows, hd.cols));
+                        } else {
+                            for (size_t k = 0; k < games.size(); ++k) {
+                                auto& g = games[k];
+                                if (!gm) gm = gmEntry.factory(cfg.verbose);   // a fresh GM per game
+                                GameScope scope(stats.empty() ? nullptr : stats[k].get());
+                                out.push_back(gm->run(
+                                    hd.cols, hd.rows,
+                                    realMap,
+                                    mapFile,
+                                    hd.maxSteps, hd.numShells,
+                                    *g.player1, g.name1,
+                                    *g.player2, g.name2,
+                                    g.factory1,
+                                    g.factory2
+                                ));
+                                if (cache)
+                                    states.push_back(hashGameState(out.back().gameState.get(),
+                                                                   hd.rows, hd.cols));
+                                out.back().gameState.reset();   // views into *gm
+                                gm.reset();
+                            }
+                        }
+
+                        for (size_t k = 0; k < batch.size(); ++k) {
+                            CompetitionRow& row = results[batch[k]];
+                            const GameResult& gr = out[k];
+                            if (journal) {
+                                journal->append(JournalRecord{
+                                    mapHashes[mi], gmName, row.a1, row.a2,
+                                    gr.winner, static_cast<int>(gr.reason), gr.rounds, mapFile
+                                });
+                            }
+                            if (cache)
+                                cache->store(cacheKey(batch[k]), CachedResult{
+                                    gr.winner, static_cast<int>(gr.reason), gr.rounds, states[k]
+                                });
+                            row.winner = gr.winner;
+                            row.reason = static_cast<int>(gr.reason);
+                            row.rounds = gr.rounds;
+                            if (!stats.empty()) allocs[batch[k]] = summarize(*stats[k]);
+                            haveResult[batch[k]] = 1;
+                            recordGame(batch[k], gr.winner);
+                            if (progress) progress->gamePlayed(gr.rounds);
+                        }
+                    } catch (const std::exception& ex) {
+                        run.error = ex.what();
+                        if (progress) progress->gamesFailed(batch.size());
+                    }
+                }));
+            }
+            releases.push_back(pool.enqueue([&localMaps, mi] { localMaps.release(mi); }, plays));
+        }
+        for (auto& rel : releases) rel.wait();   // after every play of its map
+        if (cfg.swissPairing) rateFinished();
+    }
+    if (progress) progress->stop();
+    for (size_t mi = 0; mi < mapFiles.size(); ++mi)
+        if (!mapErrors[mi].empty())
+            std::cerr << "Warning: skipping map '" << mapFiles[mi] << "': " << mapErrors[mi] << "\n";
+    for (const BatchRun& run : batchRuns)
+        if (!run.error.empty())
+            std::cerr << "Warning: games on map '" << mapFiles[run.map] << "' failed: "
+                      << run.error << "\n";
+    if (journal) journal->flush();
+    if (cache)   cache->flush();
+    size_t resumed = 0, cachedGames = 0;
+    for (size_t n : resumedOn) resumed += n;
+    for (size_t n : cachedOn)  cachedGames += n;
+
+    // 8) Report (canonical task order) & cleanup
+    std::vector<CompetitionRow> finished;
+    std::vector<AllocSummary>   finishedAllocs;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        if (!haveResult[t]) continue;
+        finished.push_back(std::move(results[t]));
+        finishedAllocs.push_back(allocs[t]);
+    }
+
+    std::string note;
+    if (cfg.shardCount > 1)
+        note += "(shard " + std::to_string(cfg.shardIndex) + "/" + std::to_string(cfg.shardCount)
+              + ": " + std::to_string(finished.size()) + " of " + std::to_string(tasks.size()) + " games)";
+    if (resumed > 0)
+        note += (note.empty() ? "" : " ") + ("(" + std::to_string(resumed) + " resumed from journal)");
+    if (cachedGames > 0)
+        note += (note.empty() ? "" : " ") + ("(" + std::to_string(cachedGames) + " from result cache)");
+    size_t skippedGames = 0;
+    for (const PairRecord& p : pairRecords) skippedGames += p.skipped;
+    if (skippedGames > 0)
+        note += (note.empty() ? "" : " ") + ("(" + std::to_string(skippedGames) + " skipped by early stop)");
+    printCompetitionReport(out, finished, note);
+    if (cfg.swissPairing) {
+        std::vector<std::string> names;
+        for (auto& path : algoPaths) names.push_back(stripSo(path));
+        printRatings(out, names, ratings,
+                     "(pairing=swiss: " + std::to_string(rounds) + " rounds, "
+                     + std::to_string(finished.size()) + " games)");
+    }
+    if (earlyStop) {
+        std::vector<PairRecord> verdicts;
+        for (size_t i = 0; i + 1 < numAlgos; ++i) {
+            for (size_t j = i + 1; j < numAlgos; ++j) {
+                PairRecord p = pairRecords[i * numAlgos + j];
+                if (p.wins + p.losses + p.draws + p.skipped == 0) continue;   // never met here
+                p.a1 = stripSo(algoPaths[i]);
+                p.a2 = stripSo(algoPaths[j]);
+                verdicts.push_back(std::move(p));
+            }
+        }
+        printPairVerdicts(out, verdicts, cfg.earlyStop);
+    }
+    if (cfg.allocStats) printAllocationReport(out, finished, finishedAllocs);
+
+    if (!cfg.shard_output.empty()) {
+        try {
+            writeShardFile(cfg.shard_output,
+                           ShardHeader{size_t(cfg.shardIndex), size_t(cfg.shardCount), tasks.size()},
+                           finished);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << "\n";
+            return 1;
+        }
     }
 
-    // dlclose(gmH);
-    // for (auto h : algoHandles) dlclose(h);
     return 0;
 }
 
+// -----------------------------
+// Batch mode
+// -----------------------------
+// Up to num_threads jobs at a time, each on its own driver thread: a driver
+// only enqueues and waits, the games themselves all go to the session's pool.
+static int runBatch(const std::vector<BatchJob>& jobs, size_t numThreads, Session& session) {
+    std::vector<char> ok(jobs.size(), 0);
+    std::atomic<size_t> next{0};
+    auto drive = [&] {
+        for (size_t j; (j = next++) < jobs.size(); ) {
+            const BatchJob& job = jobs[j];
+            try {
+                std::ofstream out(job.output, std::ios::trunc);
+                if (!out)
+                    throw std::runtime_error("cannot write '" + job.output + "'");
+                int rc = job.cfg.modeComparative
+                    ? runComparative(job.cfg, session, out)
+                    : runCompetition(job.cfg, session, out);
+                out.flush();
+                if (!out)
+                    throw std::runtime_error("cannot write '" + job.output + "'");
+                ok[j] = (rc == 0);
+            } catch (const std::exception& ex) {
+                std::cerr << "Error: batch job at line " << job.line << ": " << ex.what() << "\n";
+            }
+        }
+    };
+    size_t drivers = std::min(jobs.size(), numThreads);
+    std::vector<std::thread> threads;
+    for (size_t d = 1; d < drivers; ++d) threads.emplace_back(drive);
+    drive();
+    for (auto& t : threads) t.join();
+
+    int failed = 0;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        std::cout << "[Batch] " << jobs[j].output << ": " << (ok[j] ? "ok" : "failed") << "\n";
+        failed += !ok[j];
+    }
+    return failed ? 1 : 0;
+}
+
+// -----------------------------
+// Daemon mode
+// -----------------------------
+//------------------------------------------------------------------------------
+// The .so files of one plugin folder, for the daemon: requests name them by
+// file name, so a file added to the folder is found at its first request, and
+// a file rebuilt since it was loaded is loaded again. dlopen() of a path that
+// is already loaded returns the old image, so every version is loaded from
+// its own copy under `stage`. A version replaced by a newer one is forgotten
+// by `plugins` and unloaded once the games still running its code are over
+// (they pin it). Thread-safe.
+//------------------------------------------------------------------------------
+class PluginFolder {
+public:
+    PluginFolder(std::string dir, fs::path stage, PluginCache& plugins)
+      : dir_(std::move(dir)), stage_(std::move(stage)), plugins_(plugins) {}
+
+    // Path to load for plugin `name` ("libX" or "libX.so"). Throws
+    // std::runtime_error if there is no such plugin or it is being written.
+    std::string resolve(const std::string& name) {
+        if (name.empty() || name[0] == '.' || name.find('/') != std::string::npos)
+            throw std::runtime_error("bad plugin name '" + name + "'");
+        const std::string file = stripSo(name) + ".so";
+        const std::string path = (fs::path(dir_) / file).string();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stamp now;
+        if (!stamp(path, now))
+            throw std::runtime_error("no plugin '" + file + "' in " + dir_);
+        auto it = versions_.find(file);
+        if (it != versions_.end() && it->second.stamp == now)
+            return it->second.staged;
+
+        fs::path dest = stage_ / std::to_string(++generation_);
+        fs::create_directories(dest);
+        dest /= file;
+        fs::copy_file(path, dest, fs::copy_options::overwrite_existing);
+        Stamp after;
+        if (!stamp(path, after) || !(after == now))
+            throw std::runtime_error("plugin '" + file + "' is being replaced, try again");
+        if (it != versions_.end()) {
+            std::cerr << "[Daemon] " << path << " changed, loading it again\n";
+            // a request that resolved the old copy but has not loaded it yet
+            // is told to try again; the mapped image outlives its file
+            plugins_.forget(it->second.staged);
+            std::error_code ec;
+            fs::remove_all(fs::path(it->second.staged).parent_path(), ec);
+        }
+        auto& v = versions_[file];
+        v.stamp  = now;
+        v.staged = dest.string();
+        return v.staged;
+    }
+
+private:
+    struct Stamp {
+        fs::file_time_type mtime{};
+        std::uintmax_t     size = 0;
+        ino_t              inode = 0;
+        bool operator==(const Stamp& o) const {
+            return mtime == o.mtime && size == o.size && inode == o.inode;
+        }
+    };
+    static bool stamp(const std::string& path, Stamp& st) {
+        struct stat sb;
+        if (::stat(path.c_str(), &sb) != 0 || !S_ISREG(sb.st_mode)) return false;
+        std::error_code ec;
+        st.mtime = fs::last_write_time(path, ec);
+        st.size  = std::uintmax_t(sb.st_size);
+        st.inode = sb.st_ino;
+        return !ec;
+    }
+
+    struct Version {
+        Stamp       stamp;
+        std::string staged;
+    };
+
+    const std::string dir_;
+    const fs::path    stage_;
+    PluginCache&      plugins_;
+    std::mutex        mutex_;
+    unsigned          generation_ = 0;
+    std::unordered_map<std::string, Version> versions_;
+};
+
+// Maps the daemon keeps parsed between requests, the most recently used
+constexpr size_t kDaemonKeptMaps = 16;
+
+// Serves match requests on the socket until SIGINT/SIGTERM: each request is
+// one game, played on the session's pool with its maps, plugins and result
+// cache kept warm across requests; the reply goes out when the game ends.
+static int runDaemon(const Config& cfg, Session& session) {
+    ResultCache* cache = nullptr;
+    try {
+        cache = session.resultCache(cfg.resultCache);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+
+    std::string stageDir = (fs::temp_directory_path() / "simulator-plugins-XXXXXX").string();
+    if (!mkdtemp(&stageDir[0])) {
+        std::cerr << "Error: cannot create a plugin staging directory in "
+                  << fs::temp_directory_path() << "\n";
+        return 1;
+    }
+    PluginFolder gmFolder(cfg.game_managers_folder, fs::path(stageDir) / "gm", session.plugins());
+    PluginFolder algoFolder(cfg.algorithms_folder, fs::path(stageDir) / "algo", session.plugins());
+    ThreadPool& pool = session.pool();
+    // recently played maps stay parsed; others only while a game holds them
+    session.maps().setKeepLimit(kDaemonKeptMaps);
+
+    auto play = [&](const MatchRequest& req, MatchReply& r) {
+        auto map = session.maps().get(req.map);
+        const std::string gmPath = gmFolder.resolve(req.gm);
+        const std::string a1Path = algoFolder.resolve(req.algorithm1);
+        const std::string a2Path = algoFolder.resolve(req.algorithm2);
+        std::shared_ptr<const void> pins[3];   // released after everything below
+        GameManagerEntry gmEntry = session.plugins().gameManager(gmPath, &pins[0]);
+        AlgorithmEntry A = session.plugins().algorithm(a1Path, &pins[1]);
+        AlgorithmEntry B = session.plugins().algorithm(a2Path, &pins[2]);
+        const size_t maxSteps  = req.maxSteps  >= 0 ? size_t(req.maxSteps)  : map->maxSteps;
+        const size_t numShells = req.numShells >= 0 ? size_t(req.numShells) : map->numShells;
+
+        CacheKey key;
+        if (cache) {
+            key.gm     = session.plugins().hash(gmPath);
+            key.a1     = session.plugins().hash(a1Path);
+            key.a2     = session.plugins().hash(a2Path);
+            key.params = cacheParams(maxSteps, numShells);
+            try { key.map = hashFile(req.map); }
+            catch (const std::exception&) {}
+            CachedResult cached;
+            if (!cfg.rerun && cache->find(key, cached)) {
+                r.winner    = cached.winner;
+                r.reason    = cached.reason;
+                r.rounds    = cached.rounds;
+                r.stateHash = cached.stateHash;
+                r.cached    = true;
+                return;
+            }
+        }
+
+        auto gm = gmEntry.factory(false);
+        auto p1 = A.createPlayer(0, 0, 0, maxSteps, numShells);
+        auto p2 = B.createPlayer(1, 0, 0, maxSteps, numShells);
+        GameResult gr = gm->run(
+            map->cols, map->rows, *map->view, req.map,
+            maxSteps, numShells,
+            *p1, stripSo(a1Path),
+            *p2, stripSo(a2Path),
+            [&](int pi,int ti){ return A.createTankAlgorithm(pi,ti); },
+            [&](int pi,int ti){ return B.createTankAlgorithm(pi,ti); }
+        );
+        r.winner    = gr.winner;
+        r.reason    = static_cast<int>(gr.reason);
+        r.rounds    = gr.rounds;
+        r.stateHash = hashGameState(gr.gameState.get(), map->rows, map->cols);
+        gr.gameState.reset();   // views into *gm
+        if (cache)
+            cache->store(key, CachedResult{r.winner, r.reason, r.rounds, r.stateHash});
+    };
+
+    auto handle = [&](const MatchRequest& req, DaemonServer::Reply reply) {
+        pool.enqueue([&play, req, reply] {
+            MatchReply r;
+            r.id = req.id;
+            try { play(req, r); }
+            catch (const std::exception& ex) { r.error = ex.what(); }
+            reply(r);
+        });
+    };
+
+    int rc = 0;
+    try {
+        DaemonServer server(cfg.serveSocket, handle);
+        std::cout << "[Daemon] listening on " << cfg.serveSocket << std::endl;
+        server.run();
+        pool.shutdown();   // the games still owed a reply
+        std::cout << "[Daemon] stopped after " << server.requests() << " requests\n";
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        rc = 1;
+    }
+    if (cache) cache->flush();
+    std::error_code ec;
+    fs::remove_all(stageDir, ec);   // loaded copies stay mapped until exit
+    return rc;
+}
+
 // -----------------------------
 // main()
 // -----------------------------
@@ -400,7 +1491,50 @@ int main(int argc, char* argv[]) {
     if (!parseArguments(argc, argv, cfg)) {
         return 1;
     }
-    return cfg.modeComparative
-        ? runComparative(cfg)
-        : runCompetition(cfg);
+    std::vector<BatchJob> jobs;
+    if (!cfg.batchManifest.empty() && !parseManifest(cfg, argv[0], jobs)) {
+        return 1;
+    }
+    // read by the game manager at the start of every game (set before any
+    // game thread exists: setenv is not thread-safe)
+    if (cfg.decisionThreads > 1) {
+        setenv("SIM_DECISION_THREADS", std::to_string(cfg.decisionThreads).c_str(), 1);
+    }
+    CpuTopology topo = CpuTopology::detect();
+    if (cfg.numThreads == 0) {
+        // each game worker may bring its own decision team along
+        size_t perGame = size_t(std::max(1, cfg.decisionThreads));
+        cfg.numThreads = int(std::max<size_t>(1, topo.usableThreads() / perGame));
+        if (cfg.verbose)
+            std::cout << "[Simulator] num_threads=auto -> " << cfg.numThreads << "\n";
+    }
+    for (auto& job : jobs) job.cfg.numThreads = cfg.numThreads;
+    Session session(cfg, topo);
+    std::unique_ptr<SamplingProfiler> profiler;
+    if (!cfg.profileFile.empty()) {
+        try {
+            profiler = std::make_unique<SamplingProfiler>(cfg.profileFile, cfg.profileHz);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+    int rc;
+    if (!cfg.batchManifest.empty())
+        rc = runBatch(jobs, size_t(cfg.numThreads), session);
+    else if (!cfg.serveSocket.empty())
+        rc = runDaemon(cfg, session);
+    else
+        rc = cfg.modeComparative
+            ? runComparative(cfg, session, std::cout)
+            : runCompetition(cfg, session, std::cout);
+    if (profiler) {
+        try {
+            profiler->stop(std::cerr);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            if (rc == 0) rc = 1;
+        }
+    }
+    return rc;
 }
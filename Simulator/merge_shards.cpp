@@ -0,0 +1,68 @@
+// Simulator/merge_shards.cpp
+//
+// Combines the partial result files of a sharded competition
+// (shard=i/n shard_output=<file>) into the report a single run prints.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "CompetitionReport.hpp"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <shard_output> [<shard_output> ...]\n";
+        return 1;
+    }
+
+    std::vector<CompetitionRow> rows;
+    std::vector<bool> seenShard;
+    ShardHeader first;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            ShardHeader hdr;
+            auto part = readShardFile(argv[i], hdr);
+            if (i == 1) {
+                first = hdr;
+                seenShard.assign(hdr.shardCount, false);
+            } else if (hdr.shardCount != first.shardCount || hdr.totalTasks != first.totalTasks) {
+                throw std::runtime_error(std::string("shard file from a different competition: ") + argv[i]);
+            }
+            if (hdr.shardIndex >= hdr.shardCount) {
+                throw std::runtime_error(std::string("bad shard index in ") + argv[i]);
+            }
+            if (seenShard[hdr.shardIndex]) {
+                throw std::runtime_error("shard " + std::to_string(hdr.shardIndex) + " given twice");
+            }
+            seenShard[hdr.shardIndex] = true;
+            rows.insert(rows.end(), part.begin(), part.end());
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+
+    for (size_t s = 0; s < seenShard.size(); ++s) {
+        if (!seenShard[s]) {
+            std::cerr << "Error: missing shard " << s << "/" << first.shardCount << "\n";
+            return 1;
+        }
+    }
+
+    std::sort(rows.begin(), rows.end(), [](auto const& a, auto const& b) { return a.task < b.task; });
+    for (size_t k = 0; k < rows.size(); ++k) {
+        if (rows[k].task >= first.totalTasks || (k > 0 && rows[k].task == rows[k - 1].task)) {
+            std::cerr << "Error: duplicate or out-of-range task " << rows[k].task << "\n";
+            return 1;
+        }
+    }
+    if (rows.size() != first.totalTasks) {
+        std::cerr << "Warning: " << (first.totalTasks - rows.size())
+                  << " of " << first.totalTasks << " games missing from the shard files\n";
+    }
+
+    printCompetitionReport(std::cout, rows);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <GameResult.h>
+#include <Player.h>
+#include <SatelliteView.h>
+#include <TankAlgorithm.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace UserCommon_315634022 {
+
+// One game of a batch: what AbstractGameManager::run() takes for the two sides.
+struct BatchGame {
+    Player*              player1;
+    std::string          name1;
+    Player*              player2;
+    std::string          name2;
+    TankAlgorithmFactory factory1;
+    TankAlgorithmFactory factory2;
+};
+
+// Optional interface of a game manager that can play several games on the
+// same map at once; the simulator finds it with dynamic_cast on what the GM
+// factory returns. runBatch() returns one result per game, in order, each the
+// same as run() would give for that game alone. Their gameState views stay
+// valid until the manager runs again or is destroyed.
+class BatchGameManager {
+public:
+    virtual ~BatchGameManager() {}
+
+    virtual std::vector<GameResult> runBatch(
+        std::size_t map_width, std::size_t map_height,
+        const SatelliteView& map,
+        std::string map_name,
+        std::size_t max_steps, std::size_t num_shells,
+        const std::vector<BatchGame>& games
+    ) = 0;
+};
+
+} // namespace UserCommon_315634022
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace UserCommon_315634022 {
+
+// Shell-threat projection for tank algorithms. Every visible shell is pushed
+// forward turn by turn along the direction(s) it may be travelling, and each
+// cell records the first turn a shell reaches it. Shells move one cell per
+// turn, as the game manager moves them. Directions use the engine order:
+// N, NE, E, SE, S, SW, W, NW.
+
+// A shell seen on the board; bit d of dirMask set: may be moving in direction d.
+struct ShellSighting {
+    std::uint32_t x, y;
+    std::uint8_t  dirMask;
+};
+
+//------------------------------------------------------------------------------
+// Turns consecutive snapshots into sightings. A shell at p that had a shell at
+// p - d last turn is moving in direction d; a shell with no such predecessor
+// was just fired, so it moves away from an adjacent tank ('1'/'2'/'%') if
+// there is one, else its direction is unknown (all eight bits set).
+//------------------------------------------------------------------------------
+class ShellTracker {
+public:
+    // Scans `grid` (rows indexable as grid[y][x], '*' = shell) and appends this
+    // turn's sightings to `out`. Call once per snapshot, in turn order.
+    template <class Grid>
+    void observe(const Grid& grid, std::size_t w, std::size_t h, std::vector<ShellSighting>& out) {
+        if (w != w_ || h != h_) {
+            w_ = w; h_ = h;
+            prev_.assign(w * h, 0);
+            prevList_.clear();
+        }
+        const std::size_t first = out.size();
+        for (std::size_t y = 0; y < h; ++y) {
+            const char* row = &grid[y][0];
+            const char* p = row;
+            while ((p = static_cast<const char*>(std::memchr(p, '*', w - std::size_t(p - row))))) {
+                out.push_back({std::uint32_t(p - row), std::uint32_t(y), 0});
+                ++p;
+            }
+        }
+        for (std::size_t k = first; k < out.size(); ++k) {
+            auto& s = out[k];
+            std::uint8_t fromShell = 0, fromTank = 0;
+            for (int d = 0; d < 8; ++d) {
+                long px = long(s.x) - kDX[d], py = long(s.y) - kDY[d];
+                if (px < 0 || py < 0 || px >= long(w) || py >= long(h)) continue;
+                if (prev_[std::size_t(py) * w + std::size_t(px)]) fromShell |= std::uint8_t(1u << d);
+                char c = grid[std::size_t(py)][std::size_t(px)];
+                if (c == '1' || c == '2' || c == '%') fromTank |= std::uint8_t(1u << d);
+            }
+            s.dirMask = fromShell ? fromShell : fromTank ? fromTank : 0xFF;
+        }
+        for (std::uint32_t cell : prevList_) prev_[cell] = 0;
+        prevList_.clear();
+        for (std::size_t k = first; k < out.size(); ++k) {
+            std::uint32_t cell = out[k].y * std::uint32_t(w) + out[k].x;
+            prev_[cell] = 1;
+            prevList_.push_back(cell);
+        }
+    }
+
+    // The observed window moved: what was seen at (x, y) is now at
+    // (x + dx, y + dy). Sightings that fall outside it are forgotten.
+    void shift(long dx, long dy) {
+        std::size_t n = 0;
+        for (std::uint32_t cell : prevList_) {
+            prev_[cell] = 0;
+            long x = long(cell % w_) + dx, y = long(cell / w_) + dy;
+            if (x < 0 || y < 0 || x >= long(w_) || y >= long(h_)) continue;
+            prevList_[n++] = std::uint32_t(std::size_t(y) * w_ + std::size_t(x));
+        }
+        prevList_.resize(n);
+        for (std::uint32_t cell : prevList_) prev_[cell] = 1;
+    }
+
+private:
+    static constexpr int kDX[8] = {  0,  1,  1,  1,  0, -1, -1, -1 };
+    static constexpr int kDY[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
+
+    std::size_t w_ = 0, h_ = 0;
+    std::vector<std::uint8_t>  prev_;      // w*h: shell here last turn
+    std::vector<std::uint32_t> prevList_;  // the cells set in prev_
+};
+
+//------------------------------------------------------------------------------
+// Per-cell "turns until a shell gets here" (0 = a shell is here now, kNever =
+// not within the horizon). One directional distance transform per direction,
+// each a single sweep over rows 16 cells per instruction: row y follows from
+// row y - dy shifted by dx. E and W have no row-to-row dependency, so they are
+// swept over a transposed copy of the board where they become S and N; a
+// cell's answer is the min of both planes. Rows carry guard bytes on both
+// sides, so the ±1 column shift needs no edge cases.
+//------------------------------------------------------------------------------
+class DangerMap {
+public:
+    static constexpr std::uint8_t kNever = 255;
+
+    // Sizes the map for a w×h board with no walls (shells fly over everything).
+    void reset(std::size_t w, std::size_t h) {
+        w_ = w; h_ = h;
+        rows_.reset(w, h);
+        cols_.reset(h, w);
+        touched_.clear();
+        swept_ = false;
+    }
+
+    // Shells stop at (x,y) and never reach the cells behind it.
+    void setWall(std::size_t x, std::size_t y) {
+        rows_.mask[rows_.at(x, y)] = 0;
+        cols_.mask[cols_.at(y, x)] = 0;
+    }
+
+    // Projects `shells` up to `horizon` turns ahead (at most 254). A few
+    // shells are cheaper to walk ray by ray than to sweep the whole board for.
+    void build(const ShellSighting* shells, std::size_t n, int horizon) {
+        std::size_t steps = 0;
+        for (std::size_t k = 0; k < n; ++k) steps += std::size_t(popcount(shells[k].dirMask));
+        steps *= std::size_t(std::clamp(horizon, 0, int(kNever) - 1));
+        if (steps * kCellsPerRayStep <= w_ * h_) walkRays(shells, n, horizon);
+        else                                     sweepAll(shells, n, horizon);
+    }
+
+    // build() by one method or the other, whatever the shell count
+    // (bench_danger times both).
+    void walkRays(const ShellSighting* shells, std::size_t n, int horizon) {
+        horizon = std::clamp(horizon, 0, int(kNever) - 1);
+        if (swept_) {
+            std::fill(rows_.dist.begin(), rows_.dist.end(), kNever);
+            std::fill(cols_.dist.begin(), cols_.dist.end(), kNever);
+            swept_ = false;
+        } else {
+            for (std::uint32_t i : touched_) rows_.dist[i] = kNever;
+        }
+        touched_.clear();
+        // everything lands on rows_; cols_ stays kNever
+        auto reach = [&](std::size_t i, int t) {
+            std::uint8_t& c = rows_.dist[i];
+            if (c == kNever) touched_.push_back(std::uint32_t(i));
+            c = std::min(c, std::uint8_t(t));
+        };
+        for (std::size_t k = 0; k < n; ++k) {
+            reach(rows_.at(shells[k].x, shells[k].y), 0);
+            for (unsigned m = shells[k].dirMask; m; m &= m - 1) {
+                const int d = ctz(m);
+                long x = long(shells[k].x), y = long(shells[k].y);
+                for (int t = 1; t <= horizon; ++t) {
+                    x += kDX[d];
+                    y += kDY[d];
+                    if (y < 0 || y >= long(h_)) break;   // off the sides: a guard column
+                    const std::size_t i = rows_.at(std::size_t(x), std::size_t(y));
+                    if (!rows_.mask[i]) break;
+                    reach(i, t);
+                }
+            }
+        }
+    }
+
+    void sweepAll(const ShellSighting* shells, std::size_t n, int horizon) {
+        horizon = std::clamp(horizon, 0, int(kNever) - 1);
+        swept_ = true;
+        std::fill(rows_.dist.begin(), rows_.dist.end(), kNever);
+        std::fill(cols_.dist.begin(), cols_.dist.end(), kNever);
+        for (std::size_t k = 0; k < n; ++k) rows_.dist[rows_.at(shells[k].x, shells[k].y)] = 0;
+        if (horizon == 0) return;
+
+        // bucket the shells by direction once; a shell of unknown direction
+        // lands in all eight
+        for (auto& b : byDir_) b.clear();
+        for (std::size_t k = 0; k < n; ++k)
+            for (unsigned m = shells[k].dirMask; m; m &= m - 1)
+                byDir_[ctz(m)].push_back(std::uint32_t(k));
+
+        for (int d = 0; d < 8; ++d) {
+            if (byDir_[d].empty()) continue;
+            // E/W run down the columns of the transposed plane
+            const bool across = kDY[d] == 0;
+            Plane& pl = across ? cols_ : rows_;
+            const int dx = across ? 0 : kDX[d];
+            const int dy = across ? kDX[d] : kDY[d];
+
+            std::size_t lo = pl.h, hi = 0;
+            for (std::uint32_t k : byDir_[d]) {
+                std::size_t r = across ? shells[k].x : shells[k].y;
+                lo = std::min(lo, r);
+                hi = std::max(hi, r);
+            }
+            // only rows within `horizon` of a seed are read or written
+            const std::size_t from = lo > std::size_t(horizon) ? lo - std::size_t(horizon) : 0;
+            const std::size_t to   = std::min(pl.h - 1, hi + std::size_t(horizon));
+            std::fill(&pl.layer[from * pl.stride], &pl.layer[(to + 1) * pl.stride], kNever);
+            for (std::uint32_t k : byDir_[d])
+                pl.layer[across ? pl.at(shells[k].y, shells[k].x) : pl.at(shells[k].x, shells[k].y)] = 0;
+            sweep(pl, dx, dy, lo, hi, horizon);
+        }
+        clip(rows_, horizon);
+        clip(cols_, horizon);
+    }
+
+    std::uint8_t turnsUntilHit(std::size_t x, std::size_t y) const {
+        return std::min(rows_.dist[rows_.at(x, y)], cols_.dist[cols_.at(y, x)]);
+    }
+    std::size_t width()  const { return w_; }
+    std::size_t height() const { return h_; }
+
+private:
+    static constexpr std::size_t kGuard = 16;
+    // a ray step costs about as much as sweeping this many cells
+    // (bench_danger: 500×500, horizon 16, the two meet near 4500 shells)
+    static constexpr std::size_t kCellsPerRayStep = 2;
+    static constexpr int kDX[8] = {  0,  1,  1,  1,  0, -1, -1, -1 };
+    static constexpr int kDY[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
+
+    // A w×h byte board padded to whole 16-byte vectors plus guard columns.
+    struct Plane {
+        std::size_t w = 0, h = 0, span = 0, stride = 0;
+        std::vector<std::uint8_t> mask;    // 0xFF where a shell can enter, 0 on walls/guards
+        std::vector<std::uint8_t> dist;
+        std::vector<std::uint8_t> layer;   // distances for the direction being swept
+        std::vector<std::uint8_t> edge;    // all-kNever row read before the first one
+
+        void reset(std::size_t width, std::size_t height) {
+            w = width; h = height;
+            span = (w + 15) & ~std::size_t(15);
+            stride = kGuard + span + kGuard;
+            mask.assign(h * stride, 0);
+            for (std::size_t y = 0; y < h; ++y)
+                std::fill_n(&mask[y * stride + kGuard], w, std::uint8_t(0xFF));
+            dist.assign(h * stride, kNever);
+            layer.assign(h * stride, kNever);
+            edge.assign(stride, kNever);
+        }
+        std::size_t at(std::size_t x, std::size_t y) const { return y * stride + kGuard + x; }
+    };
+
+    // Rows in sweep order: row y = min(seed, (row y-dy shifted by dx) + 1) on
+    // enterable cells. Rows more than `horizon` past the last seed can't change.
+    static void sweep(Plane& pl, int dx, int dy, std::size_t lo, std::size_t hi, int horizon) {
+        const long first = dy > 0 ? long(lo) : long(hi);
+        const long last  = dy > 0 ? std::min(long(pl.h) - 1, long(hi) + horizon)
+                                  : std::max(0L, long(lo) - horizon);
+        for (long y = first; ; y += dy) {
+            const std::uint8_t* prev = (y == first ? &pl.edge[kGuard]
+                                        : &pl.layer[std::size_t(y - dy) * pl.stride + kGuard]) - dx;
+            std::uint8_t*       cur  = &pl.layer[std::size_t(y) * pl.stride + kGuard];
+            const std::uint8_t* m    = &pl.mask[std::size_t(y) * pl.stride + kGuard];
+            std::uint8_t*       dd   = &pl.dist[std::size_t(y) * pl.stride + kGuard];
+#if defined(__SSE2__)
+            const __m128i one  = _mm_set1_epi8(1);
+            const __m128i ones = _mm_set1_epi8(char(0xFF));
+            for (std::size_t x = 0; x < pl.span; x += 16) {
+                __m128i p = _mm_adds_epu8(load(prev + x), one);
+                __m128i v = _mm_min_epu8(load(cur + x), _mm_or_si128(p, _mm_andnot_si128(load(m + x), ones)));
+                store(cur + x, v);
+                store(dd + x, _mm_min_epu8(load(dd + x), v));
+            }
+#else
+            for (std::size_t x = 0; x < pl.span; ++x) {
+                unsigned p = m[x] ? std::min(unsigned(prev[x]) + 1, unsigned(kNever)) : kNever;
+                std::uint8_t v = std::uint8_t(std::min(unsigned(cur[x]), p));
+                cur[x] = v;
+                dd[x] = std::min(dd[x], v);
+            }
+#endif
+            if (y == last) break;
+        }
+    }
+
+    // Anything beyond the horizon reads as kNever.
+    static void clip(Plane& pl, int horizon) {
+#if defined(__SSE2__)
+        const __m128i hv   = _mm_set1_epi8(char(horizon));
+        const __m128i ones = _mm_set1_epi8(char(0xFF));
+        for (std::size_t i = 0; i + 16 <= pl.dist.size(); i += 16) {
+            __m128i v = load(&pl.dist[i]);
+            __m128i within = _mm_cmpeq_epi8(_mm_min_epu8(v, hv), v);
+            store(&pl.dist[i], _mm_or_si128(_mm_and_si128(within, v), _mm_andnot_si128(within, ones)));
+        }
+#else
+        for (auto& c : pl.dist) if (c > horizon) c = kNever;
+#endif
+    }
+
+#if defined(__SSE2__)
+    static __m128i load(const std::uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(std::uint8_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+#endif
+
+    static int popcount(unsigned v) {
+        int n = 0;
+        for (; v; v &= v - 1) ++n;
+        return n;
+    }
+    static int ctz(unsigned v) {
+        int n = 0;
+        while (!(v & 1u)) { v >>= 1; ++n; }
+        return n;
+    }
+
+    std::size_t w_ = 0, h_ = 0;
+    std::vector<std::uint32_t> byDir_[8];   // shell indices per direction
+    Plane rows_;   // the board as given: every direction but E/W
+    Plane cols_;   // transposed (x and y swapped): E/W
+    std::vector<std::uint32_t> touched_;    // rows_.dist cells the last walkRays set
+    bool swept_ = false;                    // the last build swept: both planes are dirty
+};
+
+} // namespace UserCommon_315634022
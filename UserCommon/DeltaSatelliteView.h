@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SatelliteView.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace UserCommon_315634022 {
+
+// One cell of a delta snapshot: its position and current content.
+struct CellChange {
+    std::uint32_t x, y;
+    char          c;
+};
+
+// A SatelliteView that also knows which cells changed between turns, so a
+// Player can forward only those instead of re-reading the whole board.
+// version() counts completed turns; a tank that last saw version v asks
+// changesSince(v) and patches its own copy of the grid.
+class DeltaSatelliteView : public SatelliteView {
+public:
+    virtual std::size_t width()   const = 0;
+    virtual std::size_t height()  const = 0;
+    virtual std::size_t version() const = 0;
+
+    // Appends every cell that may differ from version `since` (with its
+    // current content; duplicates allowed). Returns false if that history is
+    // no longer kept, in which case the caller needs a full snapshot.
+    virtual bool changesSince(std::size_t since, std::vector<CellChange>& out) const = 0;
+
+    // Where the tank this view was built for stands, so a Player need not
+    // search the board for it (nor tell it from its teammates). False if
+    // unknown.
+    virtual bool selfPosition(std::size_t& x, std::size_t& y) const {
+        (void)x; (void)y;
+        return false;
+    }
+};
+
+} // namespace UserCommon_315634022
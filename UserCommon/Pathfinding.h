@@ -0,0 +1,456 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace UserCommon_315634022 {
+
+// Grid pathfinding for tank algorithms. Maps are given as passable-cell
+// bitsets in the StaticMapAnalysis layout: row y is `wordsPerRow` 64-bit
+// words, bit x%64 of word x/64 set when the cell can be entered. Both
+// searchers keep their buffers between calls, so a per-turn search on the
+// same map allocates nothing after the first turn.
+
+// same direction order as the engine: N, NE, E, SE, S, SW, W, NW
+constexpr int kPathDX[8] = {  0,  1,  1,  1,  0, -1, -1, -1 };
+constexpr int kPathDY[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
+
+// Reusable bitset grid in the same layout (e.g. for dynamic obstacles/goals).
+struct BitGrid {
+    std::size_t width = 0, height = 0, wordsPerRow = 0;
+    std::vector<std::uint64_t> bits;
+
+    void reset(std::size_t w, std::size_t h) {
+        width = w; height = h; wordsPerRow = (w + 63) / 64;
+        bits.assign(wordsPerRow * h, 0);
+    }
+    bool test(std::size_t x, std::size_t y) const {
+        return (bits[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+    }
+    void set(std::size_t x, std::size_t y)   { bits[y * wordsPerRow + (x >> 6)] |=  (std::uint64_t(1) << (x & 63)); }
+    void clear(std::size_t x, std::size_t y) { bits[y * wordsPerRow + (x >> 6)] &= ~(std::uint64_t(1) << (x & 63)); }
+};
+
+//------------------------------------------------------------------------------
+// Distances of the last breadth-first search, shared by BitBfs and QueueBfs.
+// Each cell holds one word, the generation that wrote it over its distance; a
+// distance only counts when its generation is the current one, so nothing is
+// cleared between searches.
+//------------------------------------------------------------------------------
+class BfsDistances {
+public:
+    static constexpr std::uint16_t kUnreached = std::numeric_limits<std::uint16_t>::max();
+
+    std::uint16_t distance(std::size_t x, std::size_t y) const {
+        if (x >= w_ || y >= h_) return kUnreached;
+        const std::uint32_t m = mark_[y * w_ + x];
+        return (m >> 16) == generation_ ? std::uint16_t(m) : kUnreached;
+    }
+
+    // Direction (0..7) of the first move from the source on a shortest path
+    // to (tx,ty), or -1 if it was not reached. Walks back over the distances
+    // of the last run(), the same way path() does, without storing the path.
+    int firstStep(std::size_t tx, std::size_t ty) const {
+        std::uint16_t d = distance(tx, ty);
+        if (d == kUnreached || d == 0) return -1;
+        std::size_t x = tx, y = ty;
+        for (;;) {
+            int k = stepBack(x, y, d);
+            if (k < 0) return -1;
+            if (--d == 0) return k;
+        }
+    }
+
+    // Cells from (tx,ty) back to the source (source last). False if unreached.
+    bool path(std::size_t tx, std::size_t ty, std::vector<std::pair<std::size_t, std::size_t>>& out) const {
+        out.clear();
+        std::uint16_t d = distance(tx, ty);
+        if (d == kUnreached) return false;
+        std::size_t x = tx, y = ty;
+        out.emplace_back(x, y);
+        for (; d > 0; --d) {
+            if (stepBack(x, y, d) < 0) return false;
+            out.emplace_back(x, y);
+        }
+        return true;
+    }
+
+protected:
+    std::size_t w_ = 0, h_ = 0;
+    bool diagonal_ = true;
+    std::vector<std::uint32_t> mark_;                  // generation << 16 | distance
+    std::uint32_t              generation_ = 0;        // 1..0xffff
+
+    // Starts a search on a w×h board. generation_ is 1 afterwards exactly
+    // when every stamp was reset (a new size, or the generation wrapped).
+    void beginSearch(std::size_t w, std::size_t h, bool diagonal) {
+        if (w != w_ || h != h_) {
+            w_ = w; h_ = h;
+            mark_.assign(w_ * h_, 0);
+            generation_ = 0;
+        }
+        if (++generation_ > 0xffff) {           // generation wrapped: clear once
+            std::fill(mark_.begin(), mark_.end(), 0);
+            generation_ = 1;
+        }
+        diagonal_ = diagonal;
+    }
+
+    void setDist(std::size_t x, std::size_t y, std::uint16_t d) {
+        mark_[y * w_ + x] = generation_ << 16 | d;
+    }
+
+    // Moves (x,y), at distance d, to a neighbour at d-1 (the first in
+    // direction order) and returns the direction from there to (x,y); -1 if
+    // there is none.
+    int stepBack(std::size_t& x, std::size_t& y, std::uint16_t d) const {
+        for (int k = 0; k < 8; ++k) {
+            if (!diagonal_ && (k & 1)) continue;
+            long px = long(x) - kPathDX[k], py = long(y) - kPathDY[k];
+            if (px < 0 || py < 0 || px >= long(w_) || py >= long(h_)) continue;
+            if (distance(std::size_t(px), std::size_t(py)) == d - 1) {
+                x = std::size_t(px);
+                y = std::size_t(py);
+                return k;
+            }
+        }
+        return -1;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Bit-parallel breadth-first search: each layer expands the whole frontier at
+// once with word shifts (64 cells per operation), so the cost is
+// O(layers × rows × words) plus one write per reached cell. On open ground a
+// 4-connected frontier is a thin diamond, a cell or two per row, so most of
+// those words are empty: on bench_path's boards QueueBfs below is two to
+// three times faster, and it is what EvasiveTank uses. Like AStar it clears
+// nothing between calls: a row's bit words are reset the first time a search
+// reaches the row.
+//------------------------------------------------------------------------------
+class BitBfs : public BfsDistances {
+public:
+    // Searches from (sx,sy) over `passable`, moving 8-way (or 4-way when
+    // !diagonal). If `goals` is given (same layout) the search stops at the
+    // first layer touching a goal cell; goal cells need not be passable (e.g.
+    // the enemy tank). Returns true and the chosen goal in (gx,gy) if one was
+    // reached (of several in that layer, the first in row order); with no
+    // goals it fills distances up to `maxDepth` and returns false.
+    bool run(const std::uint64_t* passable, std::size_t w, std::size_t h, std::size_t wordsPerRow,
+             std::size_t sx, std::size_t sy, bool diagonal,
+             const std::uint64_t* goals = nullptr,
+             std::size_t* gx = nullptr, std::size_t* gy = nullptr,
+             std::uint16_t maxDepth = kUnreached - 1)
+    {
+        if (w != w_ || h != h_ || wordsPerRow != wpr_) {
+            wpr_ = wordsPerRow;
+            const std::size_t nWords = wpr_ * h;
+            visited_.assign(nWords, 0);
+            frontier_.assign(nWords, 0);
+            next_.assign(nWords, 0);
+            rowStamp_.assign(h, 0);
+            rowLive_.assign(h, 0);
+            nextLive_.assign(h, 0);
+        }
+        beginSearch(w, h, diagonal);
+        if (generation_ == 1) std::fill(rowStamp_.begin(), rowStamp_.end(), 0);
+        if (sx >= w_ || sy >= h_) return false;
+
+        touchRow(sy);
+        setBit(visited_, sx, sy);
+        setBit(frontier_, sx, sy);
+        setDist(sx, sy, 0);
+        rowLive_[sy] = 1;
+        std::size_t lo = sy, hi = sy;             // rows holding the frontier
+
+        for (std::uint16_t d = 1; d <= maxDepth; ++d) {
+            bool hit = false;
+            std::size_t nlo = h_, nhi = 0;
+            const std::size_t ylo = lo > 0 ? lo - 1 : 0, yhi = std::min(hi + 1, h_ - 1);
+            for (std::size_t y = ylo; y <= yhi; ++y) touchRow(y);
+            for (std::size_t y = ylo; y <= yhi; ++y) {
+                nextLive_[y] = 0;
+                std::uint64_t* out = &next_[y * wpr_];
+                // rows with no frontier above, on or below them cannot grow
+                if (!live(y) && !(y > 0 && live(y - 1)) && !(y + 1 < h_ && live(y + 1))) {
+                    std::fill(out, out + wpr_, 0);
+                    continue;
+                }
+                dilateRow(y, out);
+                std::uint64_t rowAny = 0;
+                for (std::size_t k = 0; k < wpr_; ++k) {
+                    std::uint64_t fresh = out[k] & ~visited_[y * wpr_ + k];
+                    if (goals && !hit && (fresh & goals[y * wpr_ + k])) {
+                        std::uint64_t g = fresh & goals[y * wpr_ + k];
+                        std::size_t x = k * 64 + std::size_t(ctz(g));
+                        setDist(x, y, d);
+                        if (gx) *gx = x;
+                        if (gy) *gy = y;
+                        hit = true;
+                    }
+                    fresh &= passable[y * wpr_ + k];
+                    out[k] = fresh;
+                    rowAny |= fresh;
+                }
+                if (rowAny) {
+                    nextLive_[y] = 1;
+                    nlo = std::min(nlo, y);
+                    nhi = std::max(nhi, y);
+                }
+            }
+            if (hit) return true;
+            if (nlo > nhi) break;
+            // record distances for the new layer, then make it the frontier
+            for (std::size_t y = lo; y <= hi; ++y) rowLive_[y] = 0;
+            for (std::size_t y = nlo; y <= nhi; ++y) {
+                if (!nextLive_[y]) continue;
+                rowLive_[y] = 1;
+                for (std::size_t k = 0; k < wpr_; ++k) {
+                    std::uint64_t bits = next_[y * wpr_ + k];
+                    visited_[y * wpr_ + k] |= bits;
+                    while (bits) {
+                        setDist(k * 64 + std::size_t(ctz(bits)), y, d);
+                        bits &= bits - 1;
+                    }
+                }
+            }
+            frontier_.swap(next_);
+            lo = nlo;
+            hi = nhi;
+        }
+        return false;
+    }
+
+private:
+    std::size_t wpr_ = 0;
+    std::vector<std::uint64_t> visited_, frontier_, next_;
+    std::vector<std::uint32_t> rowStamp_;              // generation that last used the row
+    std::vector<std::uint8_t>  rowLive_, nextLive_;    // row has frontier bits
+
+    static int ctz(std::uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(v);
+#else
+        int n = 0;
+        while (!(v & 1)) { v >>= 1; ++n; }
+        return n;
+#endif
+    }
+
+    // first use of row y in this search: drop what earlier searches left there
+    void touchRow(std::size_t y) {
+        if (rowStamp_[y] == generation_) return;
+        rowStamp_[y] = generation_;
+        std::fill_n(&visited_[y * wpr_], wpr_, 0);
+        std::fill_n(&frontier_[y * wpr_], wpr_, 0);
+        rowLive_[y] = 0;
+    }
+    bool live(std::size_t y) const { return rowStamp_[y] == generation_ && rowLive_[y]; }
+
+    void setBit(std::vector<std::uint64_t>& g, std::size_t x, std::size_t y) {
+        g[y * wpr_ + (x >> 6)] |= std::uint64_t(1) << (x & 63);
+    }
+
+    // row | row<<1 | row>>1 with carries across word boundaries
+    void spreadRow(const std::uint64_t* row, std::uint64_t* out) const {
+        for (std::size_t k = 0; k < wpr_; ++k) {
+            std::uint64_t r  = row[k];
+            std::uint64_t lo = (r << 1) | (k > 0 ? row[k - 1] >> 63 : 0);
+            std::uint64_t hi = (r >> 1) | (k + 1 < wpr_ ? row[k + 1] << 63 : 0);
+            out[k] |= r | lo | hi;
+        }
+    }
+
+    // all cells one move away from the frontier, written into `out` for row y
+    void dilateRow(std::size_t y, std::uint64_t* out) const {
+        std::fill(out, out + wpr_, 0);
+        if (live(y)) spreadRow(&frontier_[y * wpr_], out);
+        for (int dy = -1; dy <= 1; dy += 2) {
+            long ny = long(y) + dy;
+            if (ny < 0 || ny >= long(h_) || !live(std::size_t(ny))) continue;
+            const std::uint64_t* row = &frontier_[std::size_t(ny) * wpr_];
+            if (diagonal_) {
+                spreadRow(row, out);
+            } else {
+                for (std::size_t k = 0; k < wpr_; ++k) out[k] |= row[k];
+            }
+        }
+        // keep bits past the last column clear
+        if (w_ % 64) out[wpr_ - 1] &= (std::uint64_t(1) << (w_ % 64)) - 1;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Breadth-first search over a FIFO of cells: one visit per reached cell, the
+// queue kept between calls. Whether a neighbour is still open is read from a
+// copy of the passable bitset, which stays in cache where the per-cell
+// distances would not. Same interface and results as BitBfs, including the
+// goal reported when several are equally near.
+//------------------------------------------------------------------------------
+class QueueBfs : public BfsDistances {
+public:
+    bool run(const std::uint64_t* passable, std::size_t w, std::size_t h, std::size_t wordsPerRow,
+             std::size_t sx, std::size_t sy, bool diagonal,
+             const std::uint64_t* goals = nullptr,
+             std::size_t* gx = nullptr, std::size_t* gy = nullptr,
+             std::uint16_t maxDepth = kUnreached - 1)
+    {
+        beginSearch(w, h, diagonal);
+        if (queue_.size() != w * h) queue_.resize(w * h);
+        if (sx >= w_ || sy >= h_) return false;
+        // passable and not yet reached
+        open_.assign(passable, passable + wordsPerRow * h);
+        open_[sy * wordsPerRow + (sx >> 6)] &= ~(std::uint64_t(1) << (sx & 63));
+
+        constexpr std::size_t kNone = ~std::size_t(0);
+        std::size_t best = kNone;                 // lowest cell index among the nearest goals
+        std::size_t head = 0, tail = 0;
+        const std::uint32_t gen = generation_ << 16;
+        setDist(sx, sy, 0);
+        queue_[tail++] = {std::uint32_t(sx), std::uint32_t(sy)};
+
+        // one layer at a time: every cell of layer d is queued before any of d+1
+        for (std::uint16_t d = 1; head < tail && d <= maxDepth; ++d) {
+            const std::uint32_t mark = gen | d;
+            auto visit = [&](std::size_t x, std::size_t y) {
+                const std::size_t word = y * wordsPerRow + (x >> 6);
+                const std::uint64_t bit = std::uint64_t(1) << (x & 63);
+                if (goals && (goals[word] & bit)) {
+                    const std::size_t n = y * w_ + x;
+                    if ((mark_[n] >> 16) == generation_) return;   // e.g. the source
+                    mark_[n] = mark;
+                    best = std::min(best, n);
+                } else if (open_[word] & bit) {
+                    open_[word] &= ~bit;
+                    mark_[y * w_ + x] = mark;
+                    queue_[tail++] = {std::uint32_t(x), std::uint32_t(y)};
+                }
+            };
+            for (const std::size_t layerEnd = tail; head < layerEnd; ++head) {
+                const std::size_t x = queue_[head].x, y = queue_[head].y;
+                const bool up = y > 0, down = y + 1 < h_, left = x > 0, right = x + 1 < w_;
+                if (up)                      visit(x, y - 1);
+                if (diagonal_ && up && right)   visit(x + 1, y - 1);
+                if (right)                   visit(x + 1, y);
+                if (diagonal_ && down && right) visit(x + 1, y + 1);
+                if (down)                    visit(x, y + 1);
+                if (diagonal_ && down && left)  visit(x - 1, y + 1);
+                if (left)                    visit(x - 1, y);
+                if (diagonal_ && up && left)    visit(x - 1, y - 1);
+            }
+            if (best != kNone) {
+                if (gx) *gx = best % w_;
+                if (gy) *gy = best / w_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Cell { std::uint32_t x, y; };
+    std::vector<Cell>          queue_;         // every cell enters at most once
+    std::vector<std::uint64_t> open_;
+};
+
+//------------------------------------------------------------------------------
+// A* to a single target with preallocated, reusable buffers: the open list is
+// a binary heap in a kept vector and per-cell scores are invalidated by a
+// generation stamp instead of being cleared, so each call costs only the
+// cells it actually touches.
+//------------------------------------------------------------------------------
+class AStar {
+public:
+    // Shortest path length from (sx,sy) to (tx,ty), or -1. The target need not
+    // be passable. Afterwards firstStep() gives the first move's direction.
+    long run(const std::uint64_t* passable, std::size_t w, std::size_t h, std::size_t wordsPerRow,
+             std::size_t sx, std::size_t sy, std::size_t tx, std::size_t ty, bool diagonal)
+    {
+        if (w * h != g_.size()) {
+            g_.assign(w * h, 0);
+            stamp_.assign(w * h, 0);
+            from_.assign(w * h, 0);
+            generation_ = 0;
+        }
+        if (++generation_ == 0) {               // stamp wrapped: clear once
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            generation_ = 1;
+        }
+        w_ = w; sx_ = sx; sy_ = sy; tx_ = tx; ty_ = ty;
+        found_ = false;
+        open_.clear();
+        if (sx >= w || sy >= h || tx >= w || ty >= h) return -1;
+
+        auto heur = [&](std::size_t x, std::size_t y) -> std::uint32_t {
+            std::size_t dx = x > tx ? x - tx : tx - x;
+            std::size_t dy = y > ty ? y - ty : ty - y;
+            return std::uint32_t(diagonal ? std::max(dx, dy) : dx + dy);
+        };
+        auto cmp = [](const Node& a, const Node& b) {
+            return a.f != b.f ? a.f > b.f : a.g < b.g;   // min-f, deeper first on ties
+        };
+
+        std::size_t s = sy * w + sx;
+        stamp_[s] = generation_;
+        g_[s] = 0;
+        open_.push_back({std::uint32_t(s), heur(sx, sy), 0});
+
+        while (!open_.empty()) {
+            std::pop_heap(open_.begin(), open_.end(), cmp);
+            Node cur = open_.back();
+            open_.pop_back();
+            if (cur.g != g_[cur.cell]) continue;                 // stale entry
+            std::size_t cx = cur.cell % w, cy = cur.cell / w;
+            if (cx == tx && cy == ty) { found_ = true; return long(cur.g); }
+
+            for (int k = 0; k < 8; ++k) {
+                if (!diagonal && (k & 1)) continue;
+                long nx = long(cx) + kPathDX[k], ny = long(cy) + kPathDY[k];
+                if (nx < 0 || ny < 0 || nx >= long(w) || ny >= long(h)) continue;
+                std::size_t ux = std::size_t(nx), uy = std::size_t(ny);
+                bool isTarget = ux == tx && uy == ty;
+                if (!isTarget && !((passable[uy * wordsPerRow + (ux >> 6)] >> (ux & 63)) & 1u)) continue;
+                std::size_t n = uy * w + ux;
+                std::uint32_t ng = cur.g + 1;
+                if (stamp_[n] == generation_ && g_[n] <= ng) continue;
+                stamp_[n] = generation_;
+                g_[n]     = ng;
+                from_[n]  = std::uint8_t(k);
+                open_.push_back({std::uint32_t(n), ng + heur(ux, uy), ng});
+                std::push_heap(open_.begin(), open_.end(), cmp);
+            }
+        }
+        return -1;
+    }
+
+    // Direction (0..7) of the first move of the last found path, or -1.
+    int firstStep() const {
+        if (!found_ || (sx_ == tx_ && sy_ == ty_)) return -1;
+        std::size_t x = tx_, y = ty_;
+        int dir = -1;
+        while (!(x == sx_ && y == sy_)) {
+            dir = from_[y * w_ + x];
+            x = std::size_t(long(x) - kPathDX[dir]);
+            y = std::size_t(long(y) - kPathDY[dir]);
+        }
+        return dir;
+    }
+
+private:
+    struct Node {
+        std::uint32_t cell;
+        std::uint32_t f, g;
+    };
+    std::vector<Node>          open_;
+    std::vector<std::uint32_t> g_, stamp_;
+    std::vector<std::uint8_t>  from_;
+    std::uint32_t              generation_ = 0;
+    std::size_t                w_ = 0, sx_ = 0, sy_ = 0, tx_ = 0, ty_ = 0;
+    bool                       found_ = false;
+};
+
+} // namespace UserCommon_315634022
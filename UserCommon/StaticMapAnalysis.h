@@ -0,0 +1,113 @@
+#pragma once
+
+#include <SatelliteView.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace UserCommon_315634022 {
+
+// Read-only facts about a map's static terrain. The simulator computes them
+// the first time a view of the map is asked for them, and every game on that
+// map shares the same copy, so algorithms get distance fields and
+// line-of-sight lengths for free.
+struct StaticMapAnalysis {
+    static constexpr std::uint16_t kFar = std::numeric_limits<std::uint16_t>::max();
+
+    // same direction order as the engine: N, NE, E, SE, S, SW, W, NW
+    static constexpr int DX[8] = {  0,  1,  1,  1,  0, -1, -1, -1 };
+    static constexpr int DY[8] = { -1, -1,  0,  1,  1,  1,  0, -1 };
+
+    std::size_t width = 0, height = 0;
+    std::size_t wordsPerRow = 0;              // 64-bit words per passable row
+
+    std::vector<std::uint64_t> passable;      // bit x of word y*wordsPerRow + x/64: cell is '.'
+    std::vector<std::uint16_t> wallDistance;  // 8-neighbour steps to the nearest '#', kFar if none
+    std::vector<std::uint16_t> rayLength;     // [(y*width + x)*8 + dir]: passable cells before a blocker/edge
+
+    bool isPassable(std::size_t x, std::size_t y) const {
+        return (passable[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+    }
+    std::uint16_t wallDist(std::size_t x, std::size_t y) const {
+        return wallDistance[y * width + x];
+    }
+    std::uint16_t ray(std::size_t x, std::size_t y, int dir) const {
+        return rayLength[(y * width + x) * 8 + std::size_t(dir)];
+    }
+
+    static std::shared_ptr<const StaticMapAnalysis>
+    compute(const SatelliteView& map, std::size_t w, std::size_t h) {
+        auto a = std::make_shared<StaticMapAnalysis>();
+        a->width       = w;
+        a->height      = h;
+        a->wordsPerRow = (w + 63) / 64;
+        a->passable.assign(a->wordsPerRow * h, 0);
+        a->wallDistance.assign(w * h, kFar);
+        a->rayLength.assign(w * h * 8, 0);
+
+        // 1) one read of the map: passable bits + multi-source BFS seeds
+        std::vector<std::uint32_t> frontier;
+        for (std::size_t y = 0; y < h; ++y) {
+            for (std::size_t x = 0; x < w; ++x) {
+                char c = map.getObjectAt(x, y);
+                if (c == '.') a->passable[y * a->wordsPerRow + (x >> 6)] |= std::uint64_t(1) << (x & 63);
+                if (c == '#') {
+                    a->wallDistance[y * w + x] = 0;
+                    frontier.push_back(std::uint32_t(y * w + x));
+                }
+            }
+        }
+
+        // 2) wall distance field, BFS outward from every wall at once
+        std::vector<std::uint32_t> next;
+        for (std::uint16_t d = 1; !frontier.empty() && d < kFar; ++d) {
+            next.clear();
+            for (std::uint32_t cell : frontier) {
+                long cx = long(cell % w), cy = long(cell / w);
+                for (int k = 0; k < 8; ++k) {
+                    long nx = cx + DX[k], ny = cy + DY[k];
+                    if (nx < 0 || ny < 0 || nx >= long(w) || ny >= long(h)) continue;
+                    auto& dist = a->wallDistance[std::size_t(ny) * w + std::size_t(nx)];
+                    if (dist != kFar) continue;
+                    dist = d;
+                    next.push_back(std::uint32_t(std::size_t(ny) * w + std::size_t(nx)));
+                }
+            }
+            frontier.swap(next);
+        }
+
+        // 3) ray lengths: ray(p, d) = passable(p+d) ? 1 + ray(p+d, d) : 0,
+        //    filled in an order where p+d is always done before p
+        for (int k = 0; k < 8; ++k) {
+            const bool yFwd = DY[k] <= 0, xFwd = DX[k] <= 0;
+            for (std::size_t iy = 0; iy < h; ++iy) {
+                std::size_t y = yFwd ? iy : h - 1 - iy;
+                for (std::size_t ix = 0; ix < w; ++ix) {
+                    std::size_t x = xFwd ? ix : w - 1 - ix;
+                    long nx = long(x) + DX[k], ny = long(y) + DY[k];
+                    std::uint16_t len = 0;
+                    if (nx >= 0 && ny >= 0 && nx < long(w) && ny < long(h) &&
+                        a->isPassable(std::size_t(nx), std::size_t(ny))) {
+                        std::uint16_t beyond = a->ray(std::size_t(nx), std::size_t(ny), k);
+                        len = beyond == kFar ? kFar : std::uint16_t(beyond + 1);
+                    }
+                    a->rayLength[(y * w + x) * 8 + std::size_t(k)] = len;
+                }
+            }
+        }
+        return a;
+    }
+};
+
+// Implemented by map views that carry a precomputed analysis (the simulator's
+// MapView, and the GM's per-turn view forwarding it).
+class StaticMapAnalysisProvider {
+public:
+    virtual ~StaticMapAnalysisProvider() {}
+    virtual const StaticMapAnalysis* staticAnalysis() const = 0;
+};
+
+} // namespace UserCommon_315634022
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "AbstractGameManager.h"
+#include "Player.h"
+#include "TankAlgorithm.h"
+
+namespace UserCommon_315634022 {
+
+// Plugin table for the monolithic build (Simulator: `make static`). With
+// SIM_STATIC_PLUGINS defined, the REGISTER_* macros expand to a static
+// StaticPluginEntry instead of a call into the .so registrars. Each entry is a
+// plain function pointer that builds the concrete class, filed under the name
+// of the .so it replaces (SIM_PLUGIN_NAME, set per plugin by the Makefile).
+// Nothing is allocated and no std::function is involved, so LTO sees every
+// factory. The simulator looks plugin names up here before trying dlopen().
+struct StaticPluginEntry {
+    using PlayerFn        = std::unique_ptr<Player> (*)(int, std::size_t, std::size_t, std::size_t, std::size_t);
+    using TankAlgorithmFn = std::unique_ptr<TankAlgorithm> (*)(int, int);
+    using GameManagerFn   = std::unique_ptr<AbstractGameManager> (*)(bool);
+
+    const char*              plugin;
+    PlayerFn                 player;
+    TankAlgorithmFn          tankAlgorithm;
+    GameManagerFn            gameManager;
+    const StaticPluginEntry* next;
+
+    StaticPluginEntry(const char* name, PlayerFn p, TankAlgorithmFn t, GameManagerFn g)
+      : plugin(name), player(p), tankAlgorithm(t), gameManager(g), next(head())
+    {
+        head() = this;
+    }
+
+    static const StaticPluginEntry*& head() {
+        static const StaticPluginEntry* first = nullptr;
+        return first;
+    }
+};
+
+// Everything registered under one plugin name (its player and tank algorithm
+// come from separate entries); all null if nothing was linked in under it.
+struct StaticPlugin {
+    StaticPluginEntry::PlayerFn        player = nullptr;
+    StaticPluginEntry::TankAlgorithmFn tankAlgorithm = nullptr;
+    StaticPluginEntry::GameManagerFn   gameManager = nullptr;
+};
+
+inline StaticPlugin findStaticPlugin(const std::string& name) {
+    StaticPlugin found;
+    for (auto* e = StaticPluginEntry::head(); e; e = e->next) {
+        if (name != e->plugin) continue;
+        if (e->player)        found.player = e->player;
+        if (e->tankAlgorithm) found.tankAlgorithm = e->tankAlgorithm;
+        if (e->gameManager)   found.gameManager = e->gameManager;
+    }
+    return found;
+}
+
+} // namespace UserCommon_315634022
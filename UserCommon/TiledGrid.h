@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace UserCommon_315634022 {
+
+// Tile geometry shared by the simulator's tiled maps and the GM's overlays:
+// kTileSize×kTileSize cells, row-major inside a tile, tiles row-major.
+constexpr std::size_t kTileShift = 6;
+constexpr std::size_t kTileSize  = std::size_t(1) << kTileShift;
+constexpr std::size_t kTileMask  = kTileSize - 1;
+constexpr std::size_t kTileCells = kTileSize * kTileSize;
+
+inline std::size_t tilesFor(std::size_t cells) { return (cells + kTileMask) >> kTileShift; }
+
+// Implemented by map views stored as tiles (the simulator's TiledMapView), so
+// a reader can skip a whole tile of one kind of cell instead of asking for
+// each of them. Tile (tx, ty) covers x in [tx*kTileSize, (tx+1)*kTileSize).
+class TileSource {
+public:
+    virtual ~TileSource() {}
+    // true, with its content in `fill`, if every cell of the tile is the same
+    virtual bool uniformTile(std::size_t tx, std::size_t ty, char& fill) const = 0;
+};
+
+// A width×height grid of T whose tiles are allocated on first write; a tile
+// never written reads as T{}. Memory follows what was written, not the area.
+template <class T>
+class SparseTileGrid {
+public:
+    void reset(std::size_t w, std::size_t h) {
+        tilesX_ = tilesFor(w);
+        owned_.clear();
+        dir_.assign(tilesX_ * tilesFor(h), nullptr);
+    }
+
+    // lookups go through plain pointers: this sits on the per-cell view path
+    T get(std::size_t x, std::size_t y) const {
+        const T* t = dir_.data()[(y >> kTileShift) * tilesX_ + (x >> kTileShift)];
+        return t ? t[((y & kTileMask) << kTileShift) | (x & kTileMask)] : T{};
+    }
+
+    T& at(std::size_t x, std::size_t y) {
+        T*& t = dir_[(y >> kTileShift) * tilesX_ + (x >> kTileShift)];
+        if (!t) {
+            owned_.emplace_back(new T[kTileCells]());
+            t = owned_.back().get();
+        }
+        return t[((y & kTileMask) << kTileShift) | (x & kTileMask)];
+    }
+
+private:
+    std::size_t tilesX_ = 0;
+    std::vector<T*> dir_;                       // null: never written
+    std::vector<std::unique_ptr<T[]>> owned_;
+};
+
+} // namespace UserCommon_315634022
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace UserCommon_315634022 {
+
+// A fixed team of threads for fork/join loops inside one game: run(n, job)
+// calls job(0..n-1) spread over the team, the calling thread included, and
+// returns once all n calls have finished. Meant for many short rounds (one or
+// two per turn), so the threads stay parked between rounds instead of being
+// spawned each time. The first exception a job throws is rethrown by run().
+class WorkerTeam {
+public:
+    // `threads` counts the caller; 1 (or 0) runs every job inline.
+    explicit WorkerTeam(std::size_t threads) {
+        for (std::size_t i = 1; i < threads; ++i)
+            workers_.emplace_back([this] { loop(); });
+    }
+
+    ~WorkerTeam() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    WorkerTeam(const WorkerTeam&) = delete;
+    WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+    std::size_t size() const { return workers_.size() + 1; }
+
+    void run(std::size_t n, const std::function<void(std::size_t)>& job) {
+        if (workers_.empty() || n <= 1) {
+            for (std::size_t i = 0; i < n; ++i) job(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            job_ = &job;
+            count_ = n;
+            next_.store(0, std::memory_order_relaxed);
+            busy_ = workers_.size();
+            ++round_;
+        }
+        wake_.notify_all();
+        work();
+
+        std::unique_lock<std::mutex> lk(m_);
+        done_.wait(lk, [this] { return busy_ == 0; });
+        job_ = nullptr;
+        if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+private:
+    void loop() {
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m_);
+                wake_.wait(lk, [&] { return stop_ || round_ != seen; });
+                if (stop_) return;
+                seen = round_;
+            }
+            work();
+            std::lock_guard<std::mutex> lk(m_);
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+
+    // Claims indices until none are left; a failure stops the round early.
+    void work() {
+        for (std::size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) < count_; ) {
+            try {
+                (*job_)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(m_);
+                if (!error_) error_ = std::current_exception();
+                next_.store(count_, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex               m_;
+    std::condition_variable  wake_, done_;
+    bool                     stop_ = false;
+    std::size_t              round_ = 0;   // bumped once per run()
+    std::size_t              busy_ = 0;    // workers still in this round
+
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::size_t              count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr       error_;
+};
+
+} // namespace UserCommon_315634022
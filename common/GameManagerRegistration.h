@@ -12,6 +12,15 @@ struct GameManagerRegistration {
   GameManagerRegistration(GameManagerFactory);
 };
 
+#ifdef SIM_STATIC_PLUGINS
+// monolithic build: straight into the static plugin table
+#include "StaticPluginTable.h"
+#define REGISTER_GAME_MANAGER(class_name) \
+static ::UserCommon_315634022::StaticPluginEntry register_me_##class_name \
+        ( SIM_PLUGIN_NAME, nullptr, nullptr, \
+          [] (bool verbose) -> std::unique_ptr<AbstractGameManager> { return std::make_unique<class_name>(verbose); } );
+#else
 #define REGISTER_GAME_MANAGER(class_name) \
 GameManagerRegistration register_me_##class_name \
         ( [] (bool verbose) { return std::make_unique<class_name>(verbose); } );
+#endif
@@ -6,7 +6,18 @@ struct PlayerRegistration {
   PlayerRegistration(PlayerFactory);
 };
 
+#ifdef SIM_STATIC_PLUGINS
+// monolithic build: straight into the static plugin table
+#include "StaticPluginTable.h"
+#define REGISTER_PLAYER(class_name) \
+static ::UserCommon_315634022::StaticPluginEntry register_me_##class_name \
+	( SIM_PLUGIN_NAME, \
+	  [] (int player_index, size_t x, size_t y, size_t max_steps, size_t num_shells) -> std::unique_ptr<Player> { \
+        return std::make_unique<class_name>(player_index, x, y, max_steps, num_shells);}, \
+	  nullptr, nullptr );
+#else
 #define REGISTER_PLAYER(class_name) \
 PlayerRegistration register_me_##class_name \
 	( [] (int player_index, size_t x, size_t y, size_t max_steps, size_t num_shells) { \
         return std::make_unique<class_name>(player_index, x, y, max_steps, num_shells);});
+#endif
@@ -11,6 +11,20 @@ struct TankAlgorithmRegistration {
   TankAlgorithmRegistration(TankAlgorithmFactory);
 };
 
+#ifdef SIM_STATIC_PLUGINS
+// monolithic build: straight into the static plugin table
+#include "StaticPluginTable.h"
+#define REGISTER_TANK_ALGORITHM(class_name)                       \
+    static ::UserCommon_315634022::StaticPluginEntry register_me_##class_name( \
+        SIM_PLUGIN_NAME, nullptr,                                \
+        [](int player_index, int tank_index) -> std::unique_ptr<TankAlgorithm> { \
+            return std::make_unique<class_name>(                 \
+                player_index, tank_index                         \
+            );                                                    \
+        },                                                        \
+        nullptr                                                   \
+    )
+#else
 #define REGISTER_TANK_ALGORITHM(class_name)                       \
     static TankAlgorithmRegistration register_me_##class_name(   \
         [](int player_index, int tank_index) {                   \
@@ -18,4 +32,5 @@ struct TankAlgorithmRegistration {
                 player_index, tank_index                         \
             );                                                    \
         }                                                         \
-    )
\ No newline at end of file
+    )
+#endif